@@ -0,0 +1,23 @@
+/*
+ * File:        arena.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for the arena abstract data type.
+ */
+
+# ifndef ARENA_H
+# define ARENA_H
+
+# include <stddef.h>
+
+typedef struct arena ARENA;
+
+extern ARENA *createArena(void);
+
+extern void destroyArena(ARENA *ap);
+
+extern char *copyString(ARENA *ap, char *str, size_t len);
+
+extern void freeString(ARENA *ap, char *str);
+
+# endif /* ARENA_H */
@@ -0,0 +1,198 @@
+/*
+ * File:        bench.c
+ *
+ * Description: This file contains the "bench.c" main program
+ *
+ *              The program will benchmark the word counter. For each size
+ *              given with -s it writes a synthetic corpus (once, then reuses
+ *              it) whose word lengths follow the distribution chosen with
+ *              -l, optionally mixing in multi-byte UTF-8 characters (-u).
+ *              It then runs the counter with each reading strategy -r times
+ *              and prints one CSV line per run with the throughput in GB/s
+ *              and words/s and the counter's peak resident memory, so runs
+ *              can be compared between builds.
+ *
+ *              Distributions: fixed (every word 5 bytes), uniform (1-12),
+ *              geometric (mean about 5 with a long tail), and long (10-1000).
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define BUF_SIZE (1<<20) // bytes written at a time
+#define MAX_SIZES 16
+
+static const char *strategies[]={"fscanf","fread","mmap","simd","threads"};
+
+static unsigned long long state=88172645463325252ULL;
+
+static unsigned long long next(void) { // O(1)
+	state^=state<<13;
+	state^=state>>7;
+	state^=state<<17;
+	return state;
+} // xorshift64 random numbers, the same every run
+
+static int wordLength(const char *dist) { // O(1)
+	if (strcmp(dist,"fixed")==0) return 5;
+	if (strcmp(dist,"uniform")==0) return 1+next()%12;
+	if (strcmp(dist,"long")==0) return 10+next()%991;
+	int len=1;
+	while (len<64 && next()%5!=0) len++; // geometric: each extra byte with probability 4/5
+	return len;
+} // length in bytes of the next word
+
+static void makeCorpus(const char *path, size_t size, const char *dist, int utf8) { // O(n)
+	static const char *wide[]={"\xc3\xa9","\xe2\x82\xac","\xf0\x9f\x98\x80"}; // é, €, and an emoji
+	FILE *fp=fopen(path,"w");
+	if (fp==NULL) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	char *buf=malloc(BUF_SIZE+1100); // room for one word past the end
+	assert(buf!=NULL);
+	size_t done=0;
+	while (done<size) {
+		size_t n=0;
+		while (n<BUF_SIZE && done+n<size) {
+			int len=wordLength(dist);
+			int i=0;
+			while (i<len) {
+				if (utf8 && next()%5==0) {
+					const char *w=wide[next()%3];
+					size_t k=strlen(w);
+					memcpy(buf+n,w,k);
+					n+=k;
+					i+=k;
+				} else {
+					buf[n++]='a'+next()%26;
+					i++;
+				}
+			} // fill the word
+			unsigned long long r=next()%16;
+			buf[n++]=r==0?'\n':r==1?'\t':' '; // mostly spaces, some newlines and tabs
+		} // fill a block
+		if (done+n>size) n=size-done;
+		fwrite(buf,1,n,fp);
+		done+=n;
+	} // write blocks until the file is size bytes
+	free(buf);
+	fclose(fp);
+} // write a corpus of size bytes to path
+
+static double now(void) { // O(1)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec+ts.tv_nsec/1e9;
+} // seconds on a monotonic clock
+
+static unsigned long long runCounter(const char *counter, const char *strategy, const char *path, double *secs, long *rss) { // O(n)
+	int fds[2];
+	if (pipe(fds)!=0) {
+		perror("pipe");
+		exit(EXIT_FAILURE);
+	}
+	double start=now();
+	pid_t pid=fork();
+	if (pid<0) {
+		perror("fork");
+		exit(EXIT_FAILURE);
+	}
+	if (pid==0) {
+		dup2(fds[1],STDOUT_FILENO);
+		close(fds[0]);
+		close(fds[1]);
+		if (freopen("/dev/null","w",stderr)==NULL) _exit(127); // per-thread reports
+		execl(counter,counter,"-S",strategy,path,(char*)NULL);
+		_exit(127);
+	} // child: run the counter with its output in the pipe
+	close(fds[1]);
+	char out[256];
+	ssize_t got=read(fds[0],out,sizeof(out)-1);
+	close(fds[0]);
+	out[got>0?got:0]='\0';
+	int status;
+	struct rusage ru;
+	wait4(pid,&status,0,&ru);
+	*secs=now()-start;
+	*rss=ru.ru_maxrss; // KB on Linux
+	if (!WIFEXITED(status) || WEXITSTATUS(status)!=0) {
+		fprintf(stderr,"%s -S %s %s failed\n",counter,strategy,path);
+		exit(EXIT_FAILURE);
+	}
+	return strtoull(out,NULL,10); // "N total words"
+} // run one count and time it
+
+static size_t parseSize(const char *str) { // O(1)
+	char *end;
+	size_t n=strtoull(str,&end,10);
+	switch (*end) {
+		case 'k': case 'K': n<<=10; break;
+		case 'm': case 'M': n<<=20; break;
+		case 'g': case 'G': n<<=30; break;
+	} // optional binary suffix
+	return n;
+} // parse a byte count such as 4096, 64K, or 16M
+
+static void usage(const char *name) {
+	fprintf(stderr,"usage: %s [-s sizes] [-r runs] [-l fixed|uniform|geometric|long] [-u] [-d dir] [-c counter]\n",name);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+	size_t sizes[MAX_SIZES];
+	int numSizes=0;
+	int runs=3;
+	char *dist="uniform";
+	int utf8=0;
+	char *dir="/tmp";
+	char *counter="./count";
+	char *list="1M,16M,256M";
+	int opt;
+	while ((opt=getopt(argc,argv,"s:r:l:ud:c:"))!=-1) {
+		switch (opt) {
+			case 's': list=optarg; break;
+			case 'r': runs=atoi(optarg); break;
+			case 'l': dist=optarg; break;
+			case 'u': utf8=1; break;
+			case 'd': dir=optarg; break;
+			case 'c': counter=optarg; break;
+			default: usage(argv[0]);
+		}
+	} // read options
+	if (strcmp(dist,"fixed")!=0 && strcmp(dist,"uniform")!=0 && strcmp(dist,"geometric")!=0 && strcmp(dist,"long")!=0) usage(argv[0]);
+	char *copy=strdup(list);
+	char *tok;
+	for (tok=strtok(copy,","); tok!=NULL && numSizes<MAX_SIZES; tok=strtok(NULL,",")) sizes[numSizes++]=parseSize(tok);
+	free(copy);
+
+	printf("size,dist,utf8,strategy,run,seconds,gb_per_s,words_per_s,peak_rss_kb,words\n");
+	int i,k;
+	size_t j;
+	for (i=0; i<numSizes; i++) {
+		char path[4096];
+		struct stat st;
+		snprintf(path,sizeof(path),"%s/corpus-%zu-%s%s.txt",dir,sizes[i],dist,utf8?"-utf8":"");
+		if (stat(path,&st)!=0 || (size_t)st.st_size!=sizes[i]) makeCorpus(path,sizes[i],dist,utf8); // reuse earlier corpora
+		for (j=0; j<sizeof(strategies)/sizeof(strategies[0]); j++) {
+			for (k=1; k<=runs; k++) {
+				double secs;
+				long rss;
+				unsigned long long words=runCounter(counter,strategies[j],path,&secs,&rss);
+				printf("%zu,%s,%d,%s,%d,%.6f,%.3f,%.0f,%ld,%llu\n",sizes[i],dist,utf8,strategies[j],k,secs,
+					sizes[i]/secs/1e9,words/secs,rss,words);
+				fflush(stdout);
+			} // each run
+		} // each strategy
+	} // each size
+	return EXIT_SUCCESS;
+}
@@ -1,15 +1,1072 @@
+/*
+ * File:        count.c
+ *
+ * Description: This file contains the "count.c" main program
+ *
+ *              The program will take a file name as input and print the
+ *              number of words in the file, where a word is any run of
+ *              characters not containing whitespace (the same rule used by
+ *              fscanf's "%s").
+ *
+ *              The file is mapped into memory (or read in large aligned
+ *              blocks if it cannot be mapped) and scanned 64 bytes at a time.
+ *              Each block is turned into a bitmask of its whitespace bytes
+ *              using SSE2 or AVX2 compares, and words are counted as the
+ *              positions where a non-whitespace byte follows whitespace. The
+ *              same pass counts newlines and UTF-8 continuation bytes, so
+ *              lines and characters come for free.
+ *
+ *              With -t the mapped file is split into chunks (-C bytes each)
+ *              that worker threads count independently. So that a word cut
+ *              in two by a chunk boundary is counted only once, each chunk
+ *              starts out inside a word if the last byte of the chunk before
+ *              it is part of one, and only counts words that begin in it.
+ *
+ *              If no file (or "-") is given, standard input is read as a
+ *              stream with a fixed-size buffer. The -l, -w, -m, and -c flags
+ *              print lines, words, characters, and bytes in the style of wc.
+ *
+ *              Files are mapped with mapFile from "tokenizer.h". With -d the
+ *              words are split on the given delimiters instead of whitespace
+ *              and counted in one pass through the lookup table of a single
+ *              shared tokenizer rather than with the block scan.
+ *
+ *              With -f (or -k to keep only the K most common) the program
+ *              instead prints how many times each word occurs, most common
+ *              first, counted in a MAP from "map.h".
+ *
+ *              With --distinct-approx the program estimates the number of
+ *              different words with a HyperLogLog sketch from "sketch.h",
+ *              using a few KB no matter how large the vocabulary is. With -t
+ *              each thread fills its own sketch over the chunks it takes,
+ *              counting the words that start in them, and the sketches are
+ *              merged at the end.
+ *
+ *              With -H K the program follows the K most frequent words of a
+ *              stream in fixed memory using a Space-Saving SUMMARY, and with
+ *              --count-min also a Count-Min sketch to tighten the bounds.
+ *              Each word is printed with an upper and lower bound on its
+ *              count. --interval prints a snapshot every so many seconds
+ *              while the input keeps being read, for streams with no end. A
+ *              stream is polled between reads, so snapshots keep coming on
+ *              time even while it is idle.
+ *
+ *              With -b the argument is a directory (searched recursively) or
+ *              a file listing one path per line, and every file in it is
+ *              counted, printing a line per file and a total like wc. On
+ *              Linux the opens and reads of many files are kept in flight at
+ *              once through io_uring. Where io_uring isn't available (or
+ *              with --no-uring) a fixed pool of threads reads the files with
+ *              pread instead.
+ *
+ *              With -F the program keeps following a growing file, like
+ *              tail -F. It remembers how far it has read and whether that
+ *              point was inside a word, sleeps on inotify until the file
+ *              changes, and then counts only the new bytes, printing the
+ *              running total after each pass. A file that shrinks was
+ *              truncated and is read again from the start, and a new file
+ *              (inode) at the same path means the old one was rotated away:
+ *              the rest of the old file is counted before switching over.
+ *              Totals keep adding up across truncations and rotations.
+ *
+ *              -S picks how a plain word count reads the file, so the
+ *              approaches can be benchmarked against each other: fscanf
+ *              (the original loop), fread (blocks, byte-at-a-time scan),
+ *              mmap (mapping, byte-at-a-time scan), simd (the default), or
+ *              threads (simd on every core).
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 #include <stdio.h>
-#define MAX_WORD_LENGTH 30
-void main(int argc, char *argv[]) {
-	FILE *fp = fopen(*(argv+1),"r"); // open file from input
-	char word[MAX_WORD_LENGTH];
-	int total=0;
-	int scanned=1;
-	fscanf(fp,"%s",word); // get 1st word
-	while (scanned == 1) {
-		total++;
-		scanned = fscanf(fp,"%s",word); // get next word
-	} // while a word was scanned
-	printf("%d total words\n",total);
-	fclose(fp); // close file
-}
\ No newline at end of file
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#ifdef IORING_FEAT_RW_CUR_POS
+#define HAVE_URING // io_uring with IORING_OP_OPENAT (Linux 5.6)
+#endif
+#endif
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+#include "tokenizer.h"
+#include "map.h"
+#include "sketch.h"
+
+#define READ_SIZE (1<<20) // bytes per read() when the file can't be mapped
+
+#define BATCH_BLOCK (1<<17) // bytes per read in batch mode
+#define BATCH_DEPTH 64 // files in flight at once through io_uring
+#define BATCH_THREADS 8 // pool size when -t isn't given
+
+#define SHOW_LINES 1
+#define SHOW_WORDS 2
+#define SHOW_CHARS 4
+#define SHOW_BYTES 8
+
+typedef unsigned long long MASK;
+
+typedef struct counts {
+	MASK lines;
+	MASK words;
+	MASK chars;
+	MASK bytes;
+} COUNTS; // totals for one file, in the order wc prints them
+
+typedef struct worker {
+	const unsigned char *buf;
+	size_t len;
+	size_t chunk;
+	size_t *next; // offset of the next chunk nobody has taken
+	pthread_t tid;
+	COUNTS counts;
+	HLL *sketch;
+	double secs;
+} WORKER; // one counting thread and its results
+
+typedef struct heavy {
+	SUMMARY *summary;
+	CMS *cms; // NULL without --count-min
+	MASK words;
+	double interval; // seconds between snapshots, 0 for none
+	double due; // time of the next snapshot
+} HEAVY; // state of the heavy-hitters mode
+
+typedef struct job {
+	char *path;
+	COUNTS counts;
+	int error; // errno if the file couldn't be read, else 0
+} JOB; // one file of a batch
+
+typedef struct batch {
+	JOB *jobs;
+	int count;
+	int length;
+	int next; // index of the next job nobody has taken
+} BATCH; // list of files to count
+
+typedef void (*VISIT)(char *word, size_t len, void *arg);
+
+typedef int (*TICK)(void *arg); // called between blocks of a stream; returns ms until the next call
+
+static char *delims=NULL; // -d delimiters, NULL for whitespace
+static TOKENIZER *custom=NULL; // holds the lookup table for delims
+
+static int isSpace(unsigned char c) { // O(1)
+	return c==' ' || (c>='\t' && c<='\r');
+} // same characters as isspace() in the C locale
+
+static int isBreak(unsigned char c) { // O(1)
+	return custom!=NULL?isDelimiter(custom,c):isSpace(c);
+} // 1 if c separates words
+
+static void countBlocks(const unsigned char *buf, size_t n, MASK *prev, COUNTS *cp) { // O(n)
+	size_t i;
+	int j;
+	for (i=0; i<n; i+=64) {
+		MASK word=0;
+		for (j=0; j<64; j++) {
+			word|=(MASK)!isSpace(buf[i+j])<<j; // bit j set if byte j is in a word
+			cp->lines+=buf[i+j]=='\n';
+			cp->chars+=(buf[i+j]&0xC0)!=0x80; // every byte but 10xxxxxx starts a character
+		}
+		cp->words+=__builtin_popcountll(word&~(word<<1|*prev)); // word starts: in a word, previous byte not
+		*prev=word>>63;
+	} // for each 64-byte block
+} // portable version of the block scan
+
+#ifdef __SSE2__
+static void countBlocksSSE2(const unsigned char *buf, size_t n, MASK *prev, COUNTS *cp) { // O(n)
+	const __m128i sp=_mm_set1_epi8(' ');
+	const __m128i lo=_mm_set1_epi8('\t'-1);
+	const __m128i hi=_mm_set1_epi8('\r'+1);
+	const __m128i nl=_mm_set1_epi8('\n');
+	const __m128i cont=_mm_set1_epi8(-64); // 0x80-0xBF are the only bytes below this as signed
+	size_t i;
+	int j;
+	for (i=0; i<n; i+=64) {
+		MASK space=0;
+		MASK line=0;
+		MASK tail=0;
+		for (j=0; j<4; j++) {
+			__m128i v=_mm_loadu_si128((const __m128i*)(buf+i+16*j));
+			__m128i s=_mm_or_si128(_mm_cmpeq_epi8(v,sp),_mm_and_si128(_mm_cmpgt_epi8(v,lo),_mm_cmplt_epi8(v,hi)));
+			space|=(MASK)(unsigned)_mm_movemask_epi8(s)<<(16*j);
+			line|=(MASK)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v,nl))<<(16*j);
+			tail|=(MASK)(unsigned)_mm_movemask_epi8(_mm_cmplt_epi8(v,cont))<<(16*j);
+		} // classify 16 bytes at a time
+		MASK word=~space;
+		cp->words+=__builtin_popcountll(word&~(word<<1|*prev));
+		cp->lines+=__builtin_popcountll(line);
+		cp->chars+=64-__builtin_popcountll(tail);
+		*prev=word>>63;
+	} // for each 64-byte block
+} // SSE2 version of the block scan
+
+__attribute__((target("avx2,popcnt")))
+static void countBlocksAVX2(const unsigned char *buf, size_t n, MASK *prev, COUNTS *cp) { // O(n)
+	const __m256i sp=_mm256_set1_epi8(' ');
+	const __m256i lo=_mm256_set1_epi8('\t'-1);
+	const __m256i hi=_mm256_set1_epi8('\r'+1);
+	const __m256i nl=_mm256_set1_epi8('\n');
+	const __m256i cont=_mm256_set1_epi8(-64);
+	size_t i;
+	for (i=0; i<n; i+=64) {
+		__m256i a=_mm256_loadu_si256((const __m256i*)(buf+i));
+		__m256i b=_mm256_loadu_si256((const __m256i*)(buf+i+32));
+		__m256i sa=_mm256_or_si256(_mm256_cmpeq_epi8(a,sp),_mm256_and_si256(_mm256_cmpgt_epi8(a,lo),_mm256_cmpgt_epi8(hi,a)));
+		__m256i sb=_mm256_or_si256(_mm256_cmpeq_epi8(b,sp),_mm256_and_si256(_mm256_cmpgt_epi8(b,lo),_mm256_cmpgt_epi8(hi,b)));
+		MASK space=(MASK)(unsigned)_mm256_movemask_epi8(sa)|(MASK)(unsigned)_mm256_movemask_epi8(sb)<<32;
+		MASK line=(MASK)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(a,nl))|(MASK)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(b,nl))<<32;
+		MASK tail=(MASK)(unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(cont,a))|(MASK)(unsigned)_mm256_movemask_epi8(_mm256_cmpgt_epi8(cont,b))<<32;
+		MASK word=~space;
+		cp->words+=__builtin_popcountll(word&~(word<<1|*prev));
+		cp->lines+=__builtin_popcountll(line);
+		cp->chars+=64-__builtin_popcountll(tail);
+		*prev=word>>63;
+	} // for each 64-byte block
+} // AVX2 version of the block scan
+#endif
+
+static void (*scanBlocks)(const unsigned char*, size_t, MASK*, COUNTS*) = countBlocks;
+
+static void initScanner(void) { // O(1)
+#ifdef __SSE2__
+	__builtin_cpu_init();
+	scanBlocks=__builtin_cpu_supports("avx2")?countBlocksAVX2:countBlocksSSE2;
+#endif
+} // pick the widest block scan the CPU supports
+
+static void countTokens(const unsigned char *buf, size_t len, int *inWord, COUNTS *cp) { // O(n)
+	int prev=*inWord;
+	size_t i;
+	for (i=0; i<len; i++) {
+		int w=!isDelimiter(custom,buf[i]);
+		if (w && !prev) cp->words++;
+		cp->lines+=buf[i]=='\n';
+		cp->chars+=(buf[i]&0xC0)!=0x80;
+		prev=w;
+	} // one byte at a time through the lookup table
+	cp->bytes+=len;
+	*inWord=prev;
+} // add the counts for buf, splitting words on the -d delimiters
+
+static void countBuffer(const unsigned char *buf, size_t len, int *inWord, COUNTS *cp) { // O(n)
+	if (custom!=NULL) {
+		countTokens(buf,len,inWord,cp);
+		return;
+	} // the block scan only knows whitespace
+	MASK prev=*inWord;
+	size_t n=len&~(size_t)63;
+	size_t i;
+	if (n>0) scanBlocks(buf,n,&prev,cp); // whole 64-byte blocks
+	for (i=n; i<len; i++) {
+		int w=!isSpace(buf[i]);
+		if (w && !prev) cp->words++;
+		cp->lines+=buf[i]=='\n';
+		cp->chars+=(buf[i]&0xC0)!=0x80;
+		prev=w;
+	} // leftover bytes
+	cp->bytes+=len;
+	*inWord=prev;
+} // add the counts for buf to cp; inWord carries the word state across calls
+
+static double now(void) { // O(1)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return ts.tv_sec+ts.tv_nsec/1e9;
+} // seconds on a monotonic clock
+
+static void *countChunks(void *arg) { // O(n/p)
+	WORKER *wp=arg;
+	double start=now();
+	size_t s;
+	while ((s=__atomic_fetch_add(wp->next,wp->chunk,__ATOMIC_RELAXED))<wp->len) {
+		size_t e=s+wp->chunk<wp->len?s+wp->chunk:wp->len;
+		int inWord=s>0 && !isBreak(wp->buf[s-1]); // don't count a word that started in the chunk before
+		countBuffer(wp->buf+s,e-s,&inWord,&wp->counts);
+	} // take chunks until the file is used up
+	wp->secs=now()-start;
+	return NULL;
+} // worker thread: count chunks of the shared mapping
+
+static void runWorkers(WORKER *workers, int threads, const unsigned char *buf, size_t len, size_t chunk, void *(*work)(void*)) { // O(n/p)
+	if (chunk==0) chunk=(len/threads+63)&~(size_t)63; // one chunk per thread by default
+	if (chunk==0) chunk=64;
+	size_t next=0;
+	int i;
+	for (i=0; i<threads; i++) {
+		workers[i].buf=buf;
+		workers[i].len=len;
+		workers[i].chunk=chunk;
+		workers[i].next=&next;
+		if (pthread_create(&workers[i].tid,NULL,work,&workers[i])!=0) {
+			perror("pthread_create");
+			exit(EXIT_FAILURE);
+		}
+	} // start each worker
+	for (i=0; i<threads; i++) {
+		COUNTS *wc=&workers[i].counts;
+		pthread_join(workers[i].tid,NULL);
+		fprintf(stderr,"thread %d: %llu bytes, %llu words, %.3f s, %.1f MB/s\n",i,wc->bytes,wc->words,
+			workers[i].secs,workers[i].secs>0?wc->bytes/workers[i].secs/1e6:0.0);
+	} // wait for each worker and report its throughput
+} // run work on threads workers that share the chunks of buf
+
+static void countParallel(const unsigned char *buf, size_t len, int threads, size_t chunk, COUNTS *cp) { // O(n/p)
+	WORKER *workers=calloc(threads,sizeof(WORKER));
+	assert(workers!=NULL);
+	int i;
+	runWorkers(workers,threads,buf,len,chunk,countChunks);
+	for (i=0; i<threads; i++) {
+		cp->lines+=workers[i].counts.lines;
+		cp->words+=workers[i].counts.words;
+		cp->chars+=workers[i].counts.chars;
+		cp->bytes+=workers[i].counts.bytes;
+	} // add up each worker's counts
+	free(workers);
+} // count buf using threads workers
+
+static int countStream(int fd, const char *name, COUNTS *cp) { // O(n)
+	unsigned char *buf;
+	ssize_t got;
+	int inWord=0;
+	if (posix_memalign((void**)&buf,64,READ_SIZE)!=0) buf=NULL;
+	assert(buf!=NULL);
+	while ((got=read(fd,buf,READ_SIZE))>0) countBuffer(buf,got,&inWord,cp);
+	if (got<0) perror(name);
+	free(buf);
+	return got==0;
+} // count everything read from fd, one block at a time; 0 if a read failed
+
+static int countFile(const char *path, int threads, size_t chunk, COUNTS *cp) { // O(n)
+	if (strcmp(path,"-")==0) return countStream(STDIN_FILENO,"stdin",cp); // "-" is standard input
+	struct stat st;
+	if (stat(path,&st)==0 && S_ISREG(st.st_mode)) {
+		size_t len;
+		char *map=mapFile((char*)path,&len);
+		if (map!=NULL) {
+			int inWord=0;
+			if (threads>1) countParallel((unsigned char*)map,len,threads,chunk,cp);
+			else countBuffer((unsigned char*)map,len,&inWord,cp);
+			unmapFile(map,len);
+			return 1;
+		} // count the whole mapping at once
+	} // regular file
+	int fd=open(path,O_RDONLY);
+	if (fd<0) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	} // open file from input
+	int ok=countStream(fd,path,cp); // pipes and FIFOs are always counted serially
+	close(fd);
+	return ok;
+} // add the counts for the file at path to cp; 0 if a read failed
+
+static void visitTokens(char *buf, size_t len, size_t start, size_t stop, VISIT visit, void *arg) { // O(n)
+	while (start>0 && start<stop && !isBreak(buf[start-1])) start++; // that word belongs to the chunk before
+	TOKENIZER *tp=createTokenizer(buf+start,len-start,delims);
+	char *word;
+	size_t n;
+	while (nextToken(tp,&word,&n) && word<buf+stop) visit(word,n,arg); // the last word may run past stop
+	destroyTokenizer(tp);
+} // visit each token of buf that starts in [start,stop)
+
+static int streamTokens(int fd, const char *name, VISIT visit, TICK tick, void *arg) { // O(n)
+	size_t cap=READ_SIZE;
+	size_t keep=0; // bytes of an unfinished token carried over from the last block
+	char *buf=malloc(cap);
+	assert(buf!=NULL);
+	ssize_t got;
+	for (;;) {
+		if (tick!=NULL) {
+			struct pollfd pfd={.fd=fd,.events=POLLIN};
+			while (poll(&pfd,1,tick(arg))==0); // call tick again whenever its time runs out
+		} // before each read, so an idle stream still ticks
+		if ((got=read(fd,buf+keep,cap-keep))<=0) break;
+		size_t n=keep+got;
+		size_t end=n;
+		while (end>0 && !isBreak(buf[end-1])) end--; // the last token may go on in the next block
+		visitTokens(buf,end,0,end,visit,arg);
+		keep=n-end;
+		memmove(buf,buf+end,keep);
+		if (keep==cap) {
+			cap*=2;
+			buf=realloc(buf,cap);
+			assert(buf!=NULL);
+		} // one token filled the whole buffer
+	} // for each block read
+	if (got<0) perror(name);
+	if (keep>0) visitTokens(buf,keep,0,keep,visit,arg); // token ended by end of input
+	free(buf);
+	return got==0;
+} // visit each token read from fd, using memory for one block and one token; tick may be NULL; 0 if a read failed
+
+static int forEachToken(const char *path, VISIT visit, TICK tick, void *arg) { // O(n)
+	if (strcmp(path,"-")==0) return streamTokens(STDIN_FILENO,"stdin",visit,tick,arg); // "-" is standard input
+	struct stat st;
+	if (stat(path,&st)==0 && S_ISREG(st.st_mode)) {
+		size_t len;
+		char *map=mapFile((char*)path,&len);
+		if (map!=NULL) {
+			visitTokens(map,len,0,len,visit,arg);
+			unmapFile(map,len);
+			return 1;
+		} // tokens come straight out of the mapping
+	} // regular file
+	int fd=open(path,O_RDONLY);
+	if (fd<0) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	int ok=streamTokens(fd,path,visit,tick,arg);
+	close(fd);
+	return ok;
+} // visit each token in the file at path, calling tick between blocks if it is streamed; 0 if a read failed
+
+static void sketchWord(char *word, size_t len, void *arg) { // O(k)
+	WORKER *wp=arg;
+	addHLL(wp->sketch,hashToken(word,len));
+	wp->counts.words++;
+} // add one word to a worker's sketch
+
+static void *sketchChunks(void *arg) { // O(n/p)
+	WORKER *wp=arg;
+	double start=now();
+	size_t s;
+	while ((s=__atomic_fetch_add(wp->next,wp->chunk,__ATOMIC_RELAXED))<wp->len) {
+		size_t e=s+wp->chunk<wp->len?s+wp->chunk:wp->len;
+		visitTokens((char*)wp->buf,wp->len,s,e,sketchWord,wp);
+		wp->counts.bytes+=e-s;
+	} // take chunks until the file is used up
+	wp->secs=now()-start;
+	return NULL;
+} // worker thread: sketch the words starting in chunks of the shared mapping
+
+static int countDistinct(const char *path, int precision, int threads, size_t chunk) { // O(n)
+	HLL *hp=createHLL(precision);
+	struct stat st;
+	int i,ok=1;
+	if (threads>1 && stat(path,&st)==0 && S_ISREG(st.st_mode)) {
+		size_t len;
+		char *map=mapFile((char*)path,&len);
+		if (map==NULL) {
+			perror(path);
+			exit(EXIT_FAILURE);
+		}
+		WORKER *workers=calloc(threads,sizeof(WORKER));
+		assert(workers!=NULL);
+		for (i=0; i<threads; i++) workers[i].sketch=createHLL(precision);
+		runWorkers(workers,threads,(unsigned char*)map,len,chunk,sketchChunks);
+		for (i=0; i<threads; i++) {
+			mergeHLL(hp,workers[i].sketch);
+			destroyHLL(workers[i].sketch);
+		} // combine the per-thread sketches
+		free(workers);
+		unmapFile(map,len);
+	} else {
+		WORKER w;
+		memset(&w,0,sizeof(w));
+		w.sketch=hp;
+		ok=forEachToken(path,sketchWord,NULL,&w);
+	}
+	printf("%.0f distinct words\n",estimateHLL(hp));
+	destroyHLL(hp);
+	return ok;
+} // print an estimate of the number of different words in the file; 0 if a read failed
+
+static void printHeavy(HEAVY *hp) { // O(k log k)
+	COUNTER *arr=getCounters(hp->summary);
+	int i;
+	printf("# %llu words\n",hp->words);
+	for (i=0; i<numCounters(hp->summary); i++) {
+		MASK upper=arr[i].count;
+		if (hp->cms!=NULL) {
+			MASK est=estimateCMS(hp->cms,hashToken(arr[i].key,arr[i].len));
+			if (est<upper) upper=est;
+		} // both are upper bounds, so keep the smaller
+		printf("%llu %llu %.*s\n",upper,arr[i].count-arr[i].error,(int)arr[i].len,arr[i].key);
+	} // upper bound, lower bound, word
+	fflush(stdout);
+	free(arr);
+} // print a snapshot of the most frequent words
+
+static void heavyWord(char *word, size_t len, void *arg) { // O(log k)
+	HEAVY *hp=arg;
+	unsigned long long hash=hashToken(word,len);
+	addSummary(hp->summary,word,len,hash);
+	if (hp->cms!=NULL) addCMS(hp->cms,hash);
+	hp->words++;
+	if (hp->interval>0 && (hp->words&0xFFFF)==0 && now()>=hp->due) {
+		printHeavy(hp);
+		hp->due=now()+hp->interval;
+	} // a mapped file is never read in blocks, so check the clock every 64K words
+} // count one word in the heavy-hitters summary
+
+static int heavyTick(void *arg) { // O(k log k) when a snapshot is due
+	HEAVY *hp=arg;
+	double left=hp->due-now();
+	if (left<=0) {
+		printHeavy(hp);
+		hp->due=now()+hp->interval;
+		left=hp->interval;
+	} // snapshot on time even if no words came in
+	return left<1e6?(int)(left*1000)+1:1000000000; // poll takes an int
+} // print a snapshot if one is due; ms until the next one
+
+static int countHeavy(const char *path, int top, double epsilon, double interval) { // O(n log k)
+	HEAVY heavy;
+	heavy.summary=createSummary(top);
+	heavy.cms=epsilon>0?createCMS(epsilon,0.01):NULL;
+	heavy.words=0;
+	heavy.interval=interval;
+	heavy.due=now()+interval;
+	int ok=forEachToken(path,heavyWord,interval>0?heavyTick:NULL,&heavy);
+	printHeavy(&heavy);
+	destroySummary(heavy.summary);
+	if (heavy.cms!=NULL) destroyCMS(heavy.cms);
+	return ok;
+} // print the top words of the file in fixed memory; 0 if a read failed
+
+static void countWord(char *word, size_t len, void *arg) { // O(k)
+	incrementElement(arg,word,len);
+} // add one to a word's count in the MAP arg
+
+static int compareEntries(const void *a, const void *b) { // O(1)
+	const ENTRY *x=a, *y=b;
+	if (x->count!=y->count) return x->count<y->count?1:-1; // higher counts first
+	return strcmp(x->key,y->key);
+} // order entries by count, then alphabetically
+
+static int countFrequencies(const char *path, int top) { // O(n + m log m)
+	MAP *mp=createMap(1<<16);
+	int ok=forEachToken(path,countWord,NULL,mp);
+	int count=numEntries(mp);
+	ENTRY *arr=getEntries(mp);
+	int i;
+	qsort(arr,count,sizeof(ENTRY),compareEntries);
+	if (top>0 && top<count) count=top;
+	for (i=0; i<count; i++) printf("%llu %s\n",arr[i].count,arr[i].key);
+	free(arr);
+	destroyMap(mp);
+	return ok;
+} // print each word in the file with how often it occurs; 0 if a read failed
+
+static void printCounts(COUNTS *cp, int show, const char *path) {
+	MASK vals[4]={cp->lines,cp->words,cp->chars,cp->bytes};
+	int i;
+	int cols=0;
+	for (i=0; i<4; i++) if (show&(1<<i)) cols++;
+	const char *fmt=cols>1?"%7llu":"%llu"; // pad only when there are columns to line up
+	for (i=0; i<4; i++) {
+		if (!(show&(1<<i))) continue;
+		printf(fmt,vals[i]);
+		if (--cols>0) printf(" ");
+	} // selected counts in wc's order
+	if (strcmp(path,"-")!=0) printf(" %s",path);
+	printf("\n");
+} // print counts the way wc does
+
+static void addJob(BATCH *bp, char *path) { // O(1) amortized
+	if (bp->count==bp->length) {
+		bp->length=bp->length>0?bp->length*2:64;
+		bp->jobs=realloc(bp->jobs,sizeof(JOB)*bp->length);
+		assert(bp->jobs!=NULL);
+	} // double the array when full
+	memset(&bp->jobs[bp->count],0,sizeof(JOB));
+	bp->jobs[bp->count++].path=path;
+} // add path to the batch
+
+static void addDirectory(BATCH *bp, const char *dir) { // O(n)
+	DIR *dp=opendir(dir);
+	struct dirent *ep;
+	struct stat st;
+	if (dp==NULL) {
+		perror(dir);
+		return;
+	}
+	while ((ep=readdir(dp))!=NULL) {
+		if (strcmp(ep->d_name,".")==0 || strcmp(ep->d_name,"..")==0) continue;
+		char *path=malloc(strlen(dir)+strlen(ep->d_name)+2);
+		assert(path!=NULL);
+		sprintf(path,"%s/%s",dir,ep->d_name);
+		if (lstat(path,&st)==0 && S_ISDIR(st.st_mode)) {
+			addDirectory(bp,path);
+			free(path);
+		} else if (stat(path,&st)==0 && S_ISREG(st.st_mode)) addJob(bp,path);
+		else free(path);
+	} // regular files, and directories that aren't symbolic links
+	closedir(dp);
+} // add every file under dir to the batch
+
+static void *countJobs(void *arg) { // O(n/p)
+	BATCH *bp=arg;
+	unsigned char *buf;
+	int i;
+	if (posix_memalign((void**)&buf,64,BATCH_BLOCK)!=0) buf=NULL;
+	assert(buf!=NULL);
+	while ((i=__atomic_fetch_add(&bp->next,1,__ATOMIC_RELAXED))<bp->count) {
+		JOB *jp=&bp->jobs[i];
+		int fd=open(jp->path,O_RDONLY);
+		if (fd<0) {
+			jp->error=errno;
+			continue;
+		}
+		int inWord=0;
+		off_t off=0;
+		ssize_t got;
+		while ((got=pread(fd,buf,BATCH_BLOCK,off))>0) {
+			countBuffer(buf,got,&inWord,&jp->counts);
+			off+=got;
+		} // read the file block by block
+		if (got<0) jp->error=errno;
+		close(fd);
+	} // take files until the batch is used up
+	free(buf);
+	return NULL;
+} // pool thread: count whole files
+
+static void countPool(BATCH *bp, int threads) { // O(n/p)
+	pthread_t *tids=malloc(sizeof(pthread_t)*threads);
+	assert(tids!=NULL);
+	int i;
+	for (i=0; i<threads; i++) {
+		if (pthread_create(&tids[i],NULL,countJobs,bp)!=0) {
+			perror("pthread_create");
+			exit(EXIT_FAILURE);
+		}
+	} // start the pool
+	for (i=0; i<threads; i++) pthread_join(tids[i],NULL);
+	free(tids);
+} // count the batch with a fixed pool of threads
+
+#ifdef HAVE_URING
+typedef struct ring {
+	int fd;
+	unsigned *sqHead, *sqTail, *sqMask, *sqArray;
+	unsigned *cqHead, *cqTail, *cqMask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+	void *sqMap, *cqMap;
+	size_t sqLen, cqLen, sqesLen;
+	unsigned pending; // entries queued but not yet submitted
+} RING; // io_uring submission and completion queues
+
+typedef struct slot {
+	int job; // -1 when the slot is free
+	int fd; // -1 while the open is in flight
+	int inWord;
+	off_t off;
+	unsigned char *buf;
+} SLOT; // one file in flight
+
+static int openRing(RING *rp, unsigned entries) { // O(1)
+	struct io_uring_params p;
+	memset(&p,0,sizeof(p));
+	memset(rp,0,sizeof(RING));
+	rp->fd=syscall(__NR_io_uring_setup,entries,&p);
+	if (rp->fd<0) return -1;
+	if (!(p.features&IORING_FEAT_RW_CUR_POS)) {
+		close(rp->fd);
+		return -1;
+	} // kernel too old for IORING_OP_OPENAT
+	rp->sqLen=p.sq_off.array+p.sq_entries*sizeof(unsigned);
+	rp->cqLen=p.cq_off.cqes+p.cq_entries*sizeof(struct io_uring_cqe);
+	rp->sqesLen=p.sq_entries*sizeof(struct io_uring_sqe);
+	rp->sqMap=mmap(NULL,rp->sqLen,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,rp->fd,IORING_OFF_SQ_RING);
+	rp->cqMap=mmap(NULL,rp->cqLen,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,rp->fd,IORING_OFF_CQ_RING);
+	rp->sqes=mmap(NULL,rp->sqesLen,PROT_READ|PROT_WRITE,MAP_SHARED|MAP_POPULATE,rp->fd,IORING_OFF_SQES);
+	if (rp->sqMap==MAP_FAILED || rp->cqMap==MAP_FAILED || rp->sqes==MAP_FAILED) {
+		if (rp->sqMap!=MAP_FAILED) munmap(rp->sqMap,rp->sqLen);
+		if (rp->cqMap!=MAP_FAILED) munmap(rp->cqMap,rp->cqLen);
+		if (rp->sqes!=MAP_FAILED) munmap(rp->sqes,rp->sqesLen);
+		close(rp->fd);
+		return -1;
+	} // map the rings shared with the kernel
+	char *sq=rp->sqMap, *cq=rp->cqMap;
+	rp->sqHead=(unsigned*)(sq+p.sq_off.head);
+	rp->sqTail=(unsigned*)(sq+p.sq_off.tail);
+	rp->sqMask=(unsigned*)(sq+p.sq_off.ring_mask);
+	rp->sqArray=(unsigned*)(sq+p.sq_off.array);
+	rp->cqHead=(unsigned*)(cq+p.cq_off.head);
+	rp->cqTail=(unsigned*)(cq+p.cq_off.tail);
+	rp->cqMask=(unsigned*)(cq+p.cq_off.ring_mask);
+	rp->cqes=(struct io_uring_cqe*)(cq+p.cq_off.cqes);
+	return 0;
+} // set up an io_uring with room for entries requests, -1 if unsupported
+
+static void closeRing(RING *rp) { // O(1)
+	munmap(rp->sqMap,rp->sqLen);
+	munmap(rp->cqMap,rp->cqLen);
+	munmap(rp->sqes,rp->sqesLen);
+	close(rp->fd);
+} // tear down the io_uring
+
+static struct io_uring_sqe *queueEntry(RING *rp, int slot) { // O(1)
+	struct io_uring_sqe *sqe=&rp->sqes[*rp->sqTail&*rp->sqMask];
+	memset(sqe,0,sizeof(*sqe));
+	sqe->user_data=slot;
+	return sqe;
+} // next free submission entry, tagged with slot; not seen until pushEntry
+
+static void pushEntry(RING *rp) { // O(1)
+	unsigned tail=*rp->sqTail;
+	unsigned loc=tail&*rp->sqMask;
+	rp->sqArray[loc]=loc;
+	__atomic_store_n(rp->sqTail,tail+1,__ATOMIC_RELEASE); // kernel sees the entry only after it is filled in
+	rp->pending++;
+} // hand the filled-in entry from queueEntry to the kernel
+
+static void queueOpen(RING *rp, SLOT *sp, int slot, BATCH *bp) { // O(1)
+	struct io_uring_sqe *sqe=queueEntry(rp,slot);
+	sqe->opcode=IORING_OP_OPENAT;
+	sqe->fd=AT_FDCWD;
+	sqe->addr=(unsigned long)bp->jobs[sp->job].path;
+	sqe->open_flags=O_RDONLY;
+	pushEntry(rp);
+} // ask to open the slot's file
+
+static void queueRead(RING *rp, SLOT *sp, int slot) { // O(1)
+	struct io_uring_sqe *sqe=queueEntry(rp,slot);
+	sqe->opcode=IORING_OP_READ;
+	sqe->fd=sp->fd;
+	sqe->addr=(unsigned long)sp->buf;
+	sqe->len=BATCH_BLOCK;
+	sqe->off=sp->off;
+	pushEntry(rp);
+} // ask for the slot's next block
+
+static int startJob(RING *rp, SLOT *sp, int slot, BATCH *bp) { // O(1)
+	if (bp->next>=bp->count) {
+		sp->job=-1;
+		return 0;
+	} // nothing left to start
+	sp->job=bp->next++;
+	sp->fd=-1;
+	sp->inWord=0;
+	sp->off=0;
+	queueOpen(rp,sp,slot,bp);
+	return 1;
+} // put the next file in the slot, 0 if there are none left
+
+static int countRing(BATCH *bp) { // O(n)
+	RING ring;
+	if (openRing(&ring,BATCH_DEPTH)<0) return -1;
+	SLOT slots[BATCH_DEPTH];
+	int active=0;
+	int i;
+	for (i=0; i<BATCH_DEPTH; i++) {
+		if (posix_memalign((void**)&slots[i].buf,64,BATCH_BLOCK)!=0) slots[i].buf=NULL;
+		assert(slots[i].buf!=NULL);
+		active+=startJob(&ring,&slots[i],i,bp);
+	} // fill every slot
+	while (active>0) {
+		int done=syscall(__NR_io_uring_enter,ring.fd,ring.pending,1,IORING_ENTER_GETEVENTS,NULL,0);
+		if (done<0) {
+			if (errno==EINTR) continue;
+			perror("io_uring_enter");
+			exit(EXIT_FAILURE);
+		} // submit what's queued and wait for at least one completion
+		ring.pending-=done; // entries the kernel didn't take go with the next call
+		unsigned head=*ring.cqHead;
+		while (head!=__atomic_load_n(ring.cqTail,__ATOMIC_ACQUIRE)) {
+			struct io_uring_cqe *cqe=&ring.cqes[head&*ring.cqMask];
+			SLOT *sp=&slots[cqe->user_data];
+			JOB *jp=&bp->jobs[sp->job];
+			int res=cqe->res;
+			head++;
+			if (sp->fd<0) {
+				if (res<0) jp->error=-res;
+				else {
+					sp->fd=res;
+					queueRead(&ring,sp,cqe->user_data);
+					continue;
+				} // file is open, start reading it
+			} else if (res>0) {
+				countBuffer(sp->buf,res,&sp->inWord,&jp->counts);
+				sp->off+=res;
+				queueRead(&ring,sp,cqe->user_data);
+				continue;
+			} else {
+				if (res<0) jp->error=-res;
+				close(sp->fd);
+			} // end of file or read error
+			if (!startJob(&ring,sp,cqe->user_data,bp)) active--;
+		} // for each completion
+		__atomic_store_n(ring.cqHead,head,__ATOMIC_RELEASE);
+	} // until every file is done
+	for (i=0; i<BATCH_DEPTH; i++) free(slots[i].buf);
+	closeRing(&ring);
+	return 0;
+} // count the batch through io_uring, -1 if it isn't available
+#endif
+
+static void countBatch(const char *path, int threads, int uring, int show) { // O(n)
+	BATCH batch;
+	struct stat st;
+	char *list=NULL;
+	size_t len=0;
+	int i;
+	memset(&batch,0,sizeof(batch));
+	if (stat(path,&st)==0 && S_ISDIR(st.st_mode)) addDirectory(&batch,path);
+	else {
+		list=mapFile(strcmp(path,"-")==0?"/dev/stdin":(char*)path,&len);
+		if (list==NULL) {
+			perror(path);
+			exit(EXIT_FAILURE);
+		}
+		TOKENIZER *tp=createTokenizer(list,len,"\n");
+		char *name;
+		while ((name=nextWord(tp))!=NULL) addJob(&batch,name); // names point into the list
+		destroyTokenizer(tp);
+	} // a file listing one path per line
+
+#ifdef HAVE_URING
+	if (!uring || countRing(&batch)<0)
+#endif
+	countPool(&batch,threads);
+
+	COUNTS total={0,0,0,0};
+	int failed=0;
+	for (i=0; i<batch.count; i++) {
+		JOB *jp=&batch.jobs[i];
+		if (jp->error!=0) {
+			fprintf(stderr,"%s: %s\n",jp->path,strerror(jp->error));
+			failed=1;
+			continue;
+		}
+		printCounts(&jp->counts,show,jp->path);
+		total.lines+=jp->counts.lines;
+		total.words+=jp->counts.words;
+		total.chars+=jp->counts.chars;
+		total.bytes+=jp->counts.bytes;
+	} // print each file in order and add it to the total
+	printCounts(&total,show,"total");
+	if (list!=NULL) unmapFile(list,len);
+	else for (i=0; i<batch.count; i++) free(batch.jobs[i].path);
+	free(batch.jobs);
+	if (failed) exit(EXIT_FAILURE);
+} // count every file named by path and print a line for each
+
+static int catchUp(int fd, off_t *off, int *inWord, unsigned char *buf, COUNTS *cp) { // O(new bytes)
+	ssize_t got;
+	int grew=0;
+	while ((got=pread(fd,buf,READ_SIZE,*off))>0) {
+		countBuffer(buf,got,inWord,cp);
+		*off+=got;
+		grew=1;
+	} // read from where the last pass stopped to the end
+	return grew;
+} // count what was added to fd since off, 1 if anything was
+
+static void followFile(const char *path, int show) { // O(new bytes) per change
+	int notify=-1;
+#ifdef __linux__
+	notify=inotify_init1(IN_CLOEXEC);
+	if (notify>=0) {
+		char *dir=strdup(path);
+		char *slash=strrchr(dir,'/');
+		if (slash==NULL) strcpy(dir,".");
+		else if (slash==dir) slash[1]='\0';
+		else *slash='\0';
+		inotify_add_watch(notify,dir,IN_CREATE|IN_MOVED_TO); // a new file appearing at path
+		free(dir);
+	}
+#endif
+	unsigned char *buf;
+	if (posix_memalign((void**)&buf,64,READ_SIZE)!=0) buf=NULL;
+	assert(buf!=NULL);
+	COUNTS counts={0,0,0,0};
+	int fd=-1;
+	int watch=-1;
+	ino_t ino=0;
+	off_t off=0;
+	int inWord=0;
+	struct stat st;
+	while (1) {
+		int changed=0;
+		if (fd<0 && (fd=open(path,O_RDONLY))>=0) {
+			fstat(fd,&st);
+			ino=st.st_ino;
+			off=0;
+			inWord=0;
+#ifdef __linux__
+			if (notify>=0) watch=inotify_add_watch(notify,path,IN_MODIFY|IN_ATTRIB|IN_MOVE_SELF|IN_DELETE_SELF);
+#endif
+		} // start on a new file
+		if (fd>=0) {
+			if (fstat(fd,&st)==0 && st.st_size<off) {
+				off=0;
+				inWord=0;
+			} // truncated: read it again from the start
+			changed=catchUp(fd,&off,&inWord,buf,&counts);
+			if (stat(path,&st)!=0 || st.st_ino!=ino) {
+#ifdef __linux__
+				if (watch>=0) inotify_rm_watch(notify,watch);
+#endif
+				close(fd);
+				fd=-1;
+			} // rotated: the old file is finished, go to the new one next
+		}
+		if (changed) {
+			if (show) printCounts(&counts,show,path);
+			else printf("%llu total words\n",counts.words);
+			fflush(stdout);
+		} // print the running total after each pass
+		if (fd<0 && changed) continue; // don't wait to open the new file
+		if (notify>=0) {
+			struct pollfd pfd={notify,POLLIN,0};
+			char events[4096];
+			if (poll(&pfd,1,1000)>0) read(notify,events,sizeof(events)); // which event doesn't matter
+		} else sleep(1); // no inotify: check once a second
+	} // until killed
+} // keep counting the file at path as it grows
+
+static void countScanf(const char *path, COUNTS *cp) { // O(n)
+	FILE *fp=strcmp(path,"-")==0?stdin:fopen(path,"r");
+	if (fp==NULL) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	while (fscanf(fp,"%*s")!=EOF) cp->words++; // skip one word without storing it
+	if (fp!=stdin) fclose(fp);
+} // count words the way the original program did
+
+static void countFread(const char *path, COUNTS *cp) { // O(n)
+	FILE *fp=strcmp(path,"-")==0?stdin:fopen(path,"r");
+	if (fp==NULL) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+	unsigned char *buf=malloc(READ_SIZE);
+	assert(buf!=NULL);
+	size_t got;
+	int inWord=0;
+	while ((got=fread(buf,1,READ_SIZE,fp))>0) countBuffer(buf,got,&inWord,cp);
+	free(buf);
+	if (fp!=stdin) fclose(fp);
+} // count words reading stdio blocks
+
+static size_t parseSize(const char *str) { // O(1)
+	char *end;
+	size_t n=strtoull(str,&end,10);
+	switch (*end) {
+		case 'k': case 'K': n<<=10; break;
+		case 'm': case 'M': n<<=20; break;
+		case 'g': case 'G': n<<=30; break;
+	} // optional binary suffix
+	return n;
+} // parse a byte count such as 4096, 64K, or 16M
+
+static void usage(const char *name) {
+	fprintf(stderr,"usage: %s [-lwmc | -f | -k top | --distinct-approx[=precision] |\n"
+		"\t-H top [--count-min[=epsilon]] [--interval seconds] | -b [--no-uring] | -F]\n"
+		"\t[-S fscanf|fread|mmap|simd|threads] [-d delims] [-t threads] [-C chunk] [file]\n",name);
+	exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+	static const struct option longopts[]={
+		{"lines",no_argument,NULL,'l'},
+		{"words",no_argument,NULL,'w'},
+		{"chars",no_argument,NULL,'m'},
+		{"bytes",no_argument,NULL,'c'},
+		{"threads",required_argument,NULL,'t'},
+		{"chunk",required_argument,NULL,'C'},
+		{"delimiters",required_argument,NULL,'d'},
+		{"frequency",no_argument,NULL,'f'},
+		{"top",required_argument,NULL,'k'},
+		{"distinct-approx",optional_argument,NULL,'a'},
+		{"heavy-hitters",required_argument,NULL,'H'},
+		{"count-min",optional_argument,NULL,'M'},
+		{"interval",required_argument,NULL,'i'},
+		{"batch",no_argument,NULL,'b'},
+		{"no-uring",no_argument,NULL,'U'},
+		{"follow",no_argument,NULL,'F'},
+		{"strategy",required_argument,NULL,'S'},
+		{NULL,0,NULL,0}
+	};
+	int threads=1;
+	int threadsGiven=0; // -t was used, even as -t 1
+	size_t chunk=0;
+	int show=0;
+	int freq=0;
+	int top=0;
+	int precision=0;
+	int heavy=0;
+	double epsilon=0;
+	double interval=0;
+	int batch=0;
+	int uring=1;
+	int follow=0;
+	char *strategy="simd";
+	int opt;
+	while ((opt=getopt_long(argc,argv,"lwmcd:fk:a::H:M::i:bFS:t:C:",longopts,NULL))!=-1) {
+		switch (opt) {
+			case 'l': show|=SHOW_LINES; break;
+			case 'w': show|=SHOW_WORDS; break;
+			case 'm': show|=SHOW_CHARS; break;
+			case 'c': show|=SHOW_BYTES; break;
+			case 't': threads=atoi(optarg); threadsGiven=1; break;
+			case 'C': chunk=parseSize(optarg); break;
+			case 'd': delims=optarg; break;
+			case 'f': freq=1; break;
+			case 'k': freq=1; top=atoi(optarg); break;
+			case 'a': precision=optarg!=NULL?atoi(optarg):12; break; // 4 KB of registers by default
+			case 'H': heavy=atoi(optarg); break;
+			case 'M': epsilon=optarg!=NULL?atof(optarg):0.0001; break;
+			case 'i': interval=atof(optarg); break;
+			case 'b': batch=1; break;
+			case 'U': uring=0; break;
+			case 'F': follow=1; break;
+			case 'S': strategy=optarg; break;
+			default: usage(argv[0]);
+		}
+	} // read options
+	if (optind<argc-1) usage(argv[0]);
+	const char *path=optind<argc?argv[optind]:"-"; // no file means standard input
+	if (follow && strcmp(path,"-")==0) {
+		fprintf(stderr,"%s: -F needs a file; standard input can't be reopened\n",argv[0]);
+		return EXIT_FAILURE;
+	} // followFile opens path again after truncation or rotation
+	if (threads<=0) threads=sysconf(_SC_NPROCESSORS_ONLN); // -t 0 uses every core
+	if (strcmp(strategy,"fread")!=0 && strcmp(strategy,"mmap")!=0) initScanner(); // others keep the portable scan
+	if (strcmp(strategy,"threads")==0 && threads==1) threads=sysconf(_SC_NPROCESSORS_ONLN);
+	if (strcmp(strategy,"fscanf")!=0 && strcmp(strategy,"fread")!=0 && strcmp(strategy,"mmap")!=0
+		&& strcmp(strategy,"simd")!=0 && strcmp(strategy,"threads")!=0) usage(argv[0]);
+	if (delims!=NULL) custom=createTokenizer(NULL,0,delims);
+	COUNTS counts={0,0,0,0};
+	if (precision!=0 && (precision<4 || precision>18)) {
+		fprintf(stderr,"%s: precision must be between 4 and 18\n",argv[0]);
+		return EXIT_FAILURE;
+	}
+	int ok=1; // cleared when a read fails part way
+	if (follow) followFile(path,show);
+	else if (batch) countBatch(path,threadsGiven?threads:BATCH_THREADS,uring,show?show:SHOW_WORDS);
+	else if (heavy>0) ok=countHeavy(path,heavy,epsilon,interval);
+	else if (precision) ok=countDistinct(path,precision,threads,chunk);
+	else if (freq) ok=countFrequencies(path,top);
+	else {
+		if (strcmp(strategy,"fscanf")==0) countScanf(path,&counts);
+		else if (strcmp(strategy,"fread")==0) countFread(path,&counts);
+		else ok=countFile(path,threads,chunk,&counts);
+		if (show) printCounts(&counts,show,path);
+		else printf("%llu total words\n",counts.words);
+	}
+	if (custom!=NULL) destroyTokenizer(custom);
+	return ok?EXIT_SUCCESS:EXIT_FAILURE;
+}
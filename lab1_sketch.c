@@ -0,0 +1,308 @@
+/*
+ * File:        sketch.c
+ *
+ * Description: This file contains the functions for the "sketch.h" header
+ *              file
+ *
+ *              The program will create the abstract data type HLL, a
+ *              HyperLogLog sketch that estimates how many distinct tokens it
+ *              has seen using 2^precision one-byte registers, no matter how
+ *              many tokens there are. The top precision bits of a token's
+ *              hash pick a register, which keeps the longest run of leading
+ *              zeros seen in the remaining bits. Two sketches of the same
+ *              precision merge by taking the larger value of each register,
+ *              so threads can fill their own sketches and combine them at
+ *              the end.
+ *
+ *              SUMMARY is a Space-Saving summary that keeps the k most
+ *              frequent tokens of a stream in fixed memory. Each of its k
+ *              counters holds a token, its count, and how much that count
+ *              may be too high. The counters sit in an array-based min-heap
+ *              ordered by count (the same layout as the priority queue), so
+ *              a token that isn't being counted replaces the smallest
+ *              counter at the root and inherits its count as the error. A
+ *              small hash table of heap positions finds a token's counter.
+ *
+ *              CMS is a Count-Min sketch: depth rows of width counters, each
+ *              row indexed by a different hash of the token. A token's count
+ *              is at most the smallest of its counters, which is within
+ *              epsilon times the stream length of the true count with
+ *              probability 1-delta.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sketch.h"
+
+typedef struct slot {
+    char *key; // not ended by '\0'
+    size_t len;
+    size_t cap;
+    unsigned long long hash;
+    unsigned long long count;
+    unsigned long long error;
+    int entry; // where the index points at this counter
+} SLOT; // one Space-Saving counter
+
+typedef struct summary {
+    SLOT *heap; // min-heap by count
+    int *index; // heap positions by hash, -1 for unused
+    int mask; // index has mask+1 entries
+    int count;
+    int length;
+} SUMMARY; // declare SUMMARY struct
+
+typedef struct cms {
+    unsigned long long *data;
+    int width;
+    int depth;
+} CMS; // declare CMS struct
+
+typedef struct hll {
+    unsigned char *reg;
+    int precision;
+    int length; // 2^precision registers
+} HLL; // declare HLL struct
+
+unsigned long long hashToken(char *str, size_t len) { // O(k)
+    unsigned long long hash=14695981039346656037ULL;
+    while (len-->0) hash=(hash^(unsigned char)*str++)*1099511628211ULL; // 64-bit FNV-1a
+    hash^=hash>>33;
+    hash*=0xff51afd7ed558ccdULL;
+    hash^=hash>>33;
+    hash*=0xc4ceb9fe1a85ec53ULL;
+    hash^=hash>>33; // mix so every bit depends on every byte
+    return hash;
+} // 64-bit hash of the first len characters of str
+
+HLL *createHLL(int precision) { // O(m)
+    assert(precision>=4 && precision<=18);
+    HLL *hp=malloc(sizeof(HLL));
+    assert(hp!=NULL);
+    hp->precision=precision;
+    hp->length=1<<precision;
+    hp->reg=calloc(hp->length,1);
+    assert(hp->reg!=NULL);
+    return hp;
+} // create empty HLL with 2^precision registers
+
+void destroyHLL(HLL *hp) { // O(1)
+    assert(hp!=NULL);
+    free(hp->reg);
+    free(hp);
+} // free hp
+
+void addHLL(HLL *hp, unsigned long long hash) { // O(1)
+    assert(hp!=NULL);
+    int loc=hash>>(64-hp->precision); // register from the top bits
+    unsigned long long rest=hash<<hp->precision;
+    int rank=rest==0?64-hp->precision+1:__builtin_clzll(rest)+1; // position of the first 1 bit
+    if (rank>hp->reg[loc]) hp->reg[loc]=rank;
+} // record a token by its hash
+
+void mergeHLL(HLL *dst, HLL *src) { // O(m)
+    assert(dst!=NULL && src!=NULL && dst->precision==src->precision);
+    int i;
+    for (i=0; i<dst->length; i++) if (src->reg[i]>dst->reg[i]) dst->reg[i]=src->reg[i];
+} // make dst count everything src has seen
+
+double estimateHLL(HLL *hp) { // O(m)
+    assert(hp!=NULL);
+    double m=hp->length;
+    double sum=0;
+    int zeros=0;
+    int i;
+    for (i=0; i<hp->length; i++) {
+        sum+=ldexp(1.0,-hp->reg[i]);
+        if (hp->reg[i]==0) zeros++;
+    } // harmonic mean of 2^register
+    double alpha=hp->length==16?0.673:hp->length==32?0.697:hp->length==64?0.709:0.7213/(1+1.079/m);
+    double est=alpha*m*m/sum;
+    if (est<=2.5*m && zeros>0) est=m*log(m/zeros); // linear counting is better for small counts
+    return est;
+} // estimated number of distinct tokens seen
+
+#define p(x) (((x)-1)/2)
+#define l(x) ((x)*2+1)
+#define r(x) ((x)*2+2) // parent and children in the heap
+
+static int findSlot(SUMMARY *sp, char *word, size_t len, unsigned long long hash) { // O(1)
+    int loc=hash&sp->mask;
+    while (sp->index[loc]!=-1) {
+        SLOT *np=&sp->heap[sp->index[loc]];
+        if (np->hash==hash && np->len==len && memcmp(np->key,word,len)==0) return loc;
+        loc=(loc+1)&sp->mask;
+    } // until an unused entry
+    return loc;
+} // index entry for word, or the unused entry where it belongs
+
+static void unindex(SUMMARY *sp, int loc) { // O(1)
+    int next=(loc+1)&sp->mask;
+    sp->index[loc]=-1;
+    while (sp->index[next]!=-1) {
+        int home=sp->heap[sp->index[next]].hash&sp->mask;
+        if (((next-home)&sp->mask)>=((next-loc)&sp->mask)) {
+            sp->index[loc]=sp->index[next];
+            sp->heap[sp->index[loc]].entry=loc;
+            sp->index[next]=-1;
+            loc=next;
+        } // move entries back so no probe sequence crosses the hole
+        next=(next+1)&sp->mask;
+    }
+} // remove index entry loc without leaving a deleted marker
+
+static void swapSlots(SUMMARY *sp, int a, int b) { // O(1)
+    SLOT tmp=sp->heap[a];
+    sp->heap[a]=sp->heap[b];
+    sp->heap[b]=tmp;
+    sp->index[sp->heap[a].entry]=a;
+    sp->index[sp->heap[b].entry]=b;
+} // swap two heap entries and fix their index entries
+
+static void siftUp(SUMMARY *sp, int i) { // O(log k)
+    while (i>0 && sp->heap[i].count<sp->heap[p(i)].count) {
+        swapSlots(sp,i,p(i));
+        i=p(i);
+    } // while i is smaller than its parent
+} // move heap entry i up to its place
+
+static void siftDown(SUMMARY *sp, int i) { // O(log k)
+    while (l(i)<sp->count) {
+        int child=l(i);
+        if (r(i)<sp->count && sp->heap[r(i)].count<sp->heap[child].count) child=r(i);
+        if (sp->heap[i].count<=sp->heap[child].count) return;
+        swapSlots(sp,i,child);
+        i=child;
+    } // while i has a smaller child
+} // move heap entry i down after its count grew
+
+SUMMARY *createSummary(int k) { // O(k)
+    assert(k>0);
+    SUMMARY *sp=malloc(sizeof(SUMMARY));
+    assert(sp!=NULL);
+    sp->heap=calloc(k,sizeof(SLOT));
+    assert(sp->heap!=NULL);
+    int size=4;
+    while (size<2*k) size*=2; // index at most half full
+    sp->index=malloc(sizeof(int)*size);
+    assert(sp->index!=NULL);
+    memset(sp->index,-1,sizeof(int)*size);
+    sp->mask=size-1;
+    sp->count=0;
+    sp->length=k;
+    return sp;
+} // create SUMMARY that keeps k counters
+
+void destroySummary(SUMMARY *sp) { // O(k)
+    assert(sp!=NULL);
+    int i;
+    for (i=0; i<sp->length; i++) free(sp->heap[i].key);
+    free(sp->heap);
+    free(sp->index);
+    free(sp);
+} // free sp and its keys
+
+int numCounters(SUMMARY *sp) { // O(1)
+    assert(sp!=NULL);
+    return sp->count;
+} // number of tokens being counted
+
+void addSummary(SUMMARY *sp, char *word, size_t len, unsigned long long hash) { // O(log k)
+    assert(sp!=NULL);
+    int loc=findSlot(sp,word,len,hash);
+    if (sp->index[loc]!=-1) {
+        int i=sp->index[loc];
+        sp->heap[i].count++;
+        siftDown(sp,i);
+        return;
+    } // already counted
+
+    int i;
+    unsigned long long base=0;
+    if (sp->count<sp->length) {
+        i=sp->count++;
+    } else {
+        i=0;
+        base=sp->heap[0].count;
+        unindex(sp,sp->heap[0].entry);
+        loc=findSlot(sp,word,len,hash); // the removal may have moved entries
+    } // use a new counter, or take over the smallest one
+    SLOT *np=&sp->heap[i];
+    if (np->cap<len) {
+        np->key=realloc(np->key,len);
+        assert(np->key!=NULL);
+        np->cap=len;
+    } // reuse the key storage when it is big enough
+    memcpy(np->key,word,len);
+    np->len=len;
+    np->hash=hash;
+    np->count=base+1;
+    np->error=base;
+    np->entry=loc;
+    sp->index[loc]=i;
+    if (base>0) siftDown(sp,i); // the old root's count grew
+    else siftUp(sp,i); // a count of 1 belongs near the root
+} // count one occurrence of word
+
+static int compareCounters(const void *a, const void *b) { // O(1)
+    const COUNTER *x=a, *y=b;
+    if (x->count!=y->count) return x->count<y->count?1:-1;
+    size_t n=x->len<y->len?x->len:y->len;
+    int comp=memcmp(x->key,y->key,n);
+    if (comp!=0) return comp;
+    return x->len<y->len?-1:x->len>y->len;
+} // order counters by count, then by key
+
+COUNTER *getCounters(SUMMARY *sp) { // O(k log k)
+    assert(sp!=NULL);
+    COUNTER *arr=malloc(sizeof(COUNTER)*(sp->count>0?sp->count:1));
+    assert(arr!=NULL);
+    int i;
+    for (i=0; i<sp->count; i++) {
+        arr[i].key=sp->heap[i].key;
+        arr[i].len=sp->heap[i].len;
+        arr[i].count=sp->heap[i].count;
+        arr[i].error=sp->heap[i].error;
+    } // copy each counter
+    qsort(arr,sp->count,sizeof(COUNTER),compareCounters);
+    return arr;
+} // counters from highest count down; keys are valid until the next addSummary
+
+CMS *createCMS(double epsilon, double delta) { // O(w*d)
+    assert(epsilon>0 && delta>0 && delta<1);
+    CMS *cp=malloc(sizeof(CMS));
+    assert(cp!=NULL);
+    cp->width=ceil(exp(1)/epsilon);
+    cp->depth=ceil(log(1/delta));
+    if (cp->depth<1) cp->depth=1;
+    cp->data=calloc((size_t)cp->width*cp->depth,sizeof(unsigned long long));
+    assert(cp->data!=NULL);
+    return cp;
+} // create CMS within epsilon times the stream length, with probability 1-delta
+
+void destroyCMS(CMS *cp) { // O(1)
+    assert(cp!=NULL);
+    free(cp->data);
+    free(cp);
+} // free cp
+
+static size_t cell(CMS *cp, unsigned long long hash, int row) { // O(1)
+    unsigned h1=hash, h2=(hash>>32)|1;
+    return (size_t)row*cp->width+(h1+(unsigned)row*h2)%cp->width;
+} // counter for hash in row, from two halves of the hash
+
+void addCMS(CMS *cp, unsigned long long hash) { // O(d)
+    assert(cp!=NULL);
+    int i;
+    for (i=0; i<cp->depth; i++) cp->data[cell(cp,hash,i)]++;
+} // count one occurrence of the token with this hash
+
+unsigned long long estimateCMS(CMS *cp, unsigned long long hash) { // O(d)
+    assert(cp!=NULL);
+    unsigned long long min=cp->data[cell(cp,hash,0)];
+    int i;
+    for (i=1; i<cp->depth; i++) if (cp->data[cell(cp,hash,i)]<min) min=cp->data[cell(cp,hash,i)];
+    return min;
+} // upper bound on the count of the token with this hash
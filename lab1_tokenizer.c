@@ -0,0 +1,146 @@
+/*
+ * File:        tokenizer.c
+ *
+ * Description: This file contains the functions for the "tokenizer.h"
+ *              header file
+ *
+ *              The program will create the abstract data type TOKENIZER,
+ *              which walks a buffer and hands back each token as a pointer
+ *              into the buffer and a length, so nothing is copied and there
+ *              is no limit on how long a token can be. Which characters
+ *              separate tokens is kept in a 256-entry lookup table, built
+ *              from a string of delimiters (whitespace if none is given).
+ *
+ *              The file functions map a whole file into memory for the
+ *              tokenizer to walk. Files that cannot be mapped, like pipes,
+ *              are read into an anonymous mapping instead. Either way the
+ *              buffer is writable (changes are never written back) and has
+ *              a zero byte after the last character, so nextWord can end
+ *              each word in place to get an ordinary C string.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "tokenizer.h"
+
+#define READ_SIZE (1<<20) // bytes per read() when the file can't be mapped
+
+typedef struct tokenizer {
+    char *pos; // where the next search for a token starts
+    char *end;
+    unsigned char delim[256]; // 1 if the character separates tokens
+} TOKENIZER; // declare TOKENIZER struct
+
+static size_t mapLength(size_t len) { // O(1)
+    size_t page=sysconf(_SC_PAGESIZE);
+    return (len+1+page-1)/page*page;
+} // bytes mapped for a buffer of len characters plus its zero byte
+
+static char *readAll(int fd, size_t *len) { // O(n)
+    size_t cap=mapLength(READ_SIZE);
+    size_t n=0;
+    ssize_t got;
+    char *buf=mmap(NULL,cap,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (buf==MAP_FAILED) return NULL;
+    while ((got=read(fd,buf+n,cap-n-1))>0) {
+        n+=got;
+        if (cap-n-1>0) continue;
+        char *bigger=mmap(NULL,cap*2,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+        if (bigger==MAP_FAILED) {
+            munmap(buf,cap);
+            return NULL;
+        }
+        memcpy(bigger,buf,n);
+        munmap(buf,cap);
+        buf=bigger;
+        cap*=2;
+    } // double the mapping whenever it fills up
+    if (got<0) {
+        munmap(buf,cap);
+        return NULL;
+    }
+    if (cap>mapLength(n)) munmap(buf+mapLength(n),cap-mapLength(n)); // give back the unused tail
+    *len=n;
+    return buf;
+} // read everything from fd into an anonymous mapping
+
+char *mapFile(char *path, size_t *len) { // O(1) for regular files, O(n) otherwise
+    assert(path!=NULL && len!=NULL);
+    int fd=open(path,O_RDONLY);
+    if (fd<0) return NULL;
+    struct stat st;
+    char *buf;
+    if (fstat(fd,&st)!=0 || !S_ISREG(st.st_mode)) {
+        buf=readAll(fd,len);
+        close(fd);
+        return buf;
+    } // pipes and devices can't be mapped
+    buf=mmap(NULL,mapLength(st.st_size),PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+    if (buf==MAP_FAILED) {
+        close(fd);
+        return NULL;
+    } // reserve room for the file and its zero byte
+    if (st.st_size>0 && mmap(buf,st.st_size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_FIXED,fd,0)==MAP_FAILED) {
+        munmap(buf,mapLength(st.st_size));
+        close(fd);
+        return NULL;
+    } // map the file over the start of the reservation
+    madvise(buf,st.st_size,MADV_SEQUENTIAL);
+    close(fd);
+    *len=st.st_size;
+    return buf;
+} // map the file at path into memory, or NULL if it can't be read
+
+void unmapFile(char *buf, size_t len) { // O(1)
+    if (buf!=NULL) munmap(buf,mapLength(len));
+} // release a buffer returned by mapFile
+
+TOKENIZER *createTokenizer(char *buf, size_t len, char *delims) { // O(1)
+    TOKENIZER *tp=malloc(sizeof(TOKENIZER));
+    assert(tp!=NULL);
+    tp->pos=buf;
+    tp->end=buf+len;
+    memset(tp->delim,0,sizeof(tp->delim));
+    if (delims==NULL) delims=" \t\n\v\f\r"; // same characters as isspace() in the C locale
+    while (*delims!='\0') tp->delim[(unsigned char)*delims++]=1;
+    return tp;
+} // create a TOKENIZER over buf, split on the characters in delims
+
+void destroyTokenizer(TOKENIZER *tp) { // O(1)
+    assert(tp!=NULL);
+    free(tp);
+} // free tp; the buffer belongs to the caller
+
+int isDelimiter(TOKENIZER *tp, int c) { // O(1)
+    assert(tp!=NULL);
+    return tp->delim[(unsigned char)c];
+} // 1 if c separates tokens
+
+int nextToken(TOKENIZER *tp, char **word, size_t *len) { // O(k)
+    assert(tp!=NULL);
+    char *p=tp->pos;
+    while (p<tp->end && tp->delim[(unsigned char)*p]) p++; // skip delimiters
+    if (p==tp->end) {
+        tp->pos=p;
+        return 0;
+    } // no tokens left
+    *word=p;
+    while (p<tp->end && !tp->delim[(unsigned char)*p]) p++; // find the end of the token
+    *len=p-*word;
+    tp->pos=p;
+    return 1;
+} // point word at the next token and set len to its length, 0 if none left
+
+char *nextWord(TOKENIZER *tp) { // O(k)
+    char *word;
+    size_t len;
+    if (!nextToken(tp,&word,&len)) return NULL;
+    word[len]='\0'; // overwrite the delimiter (or the spare byte at the end)
+    if (tp->pos<tp->end) tp->pos++;
+    return word;
+} // next token as a C string ended in place; the buffer must be writable, with a spare byte after len
@@ -0,0 +1,116 @@
+/*
+ * File:        arena.c
+ *
+ * Description: This file contains the functions for the "arena.h" header file
+ *
+ *              The program will create the abstract data type ARENA, which
+ *              hands out storage for strings from large chunks of memory
+ *              instead of allocating each one separately. Destroying the
+ *              ARENA frees every chunk, so teardown costs one free per chunk
+ *              rather than per string.
+ *
+ *              The first chunk is small, so an ARENA behind a tiny SET costs
+ *              little, and each new chunk is twice the size of the last up to
+ *              CHUNK_SIZE. A string longer than that gets a chunk of its own.
+ *
+ *              Each string gets a block rounded up to a size class: steps of
+ *              8 bytes up to SMALL_SIZE, then powers of two. freeString puts
+ *              a block on a free list for its class, linked through the
+ *              block's first bytes, and copyString takes a block from that
+ *              list before carving a new one. A SET that keeps adding and
+ *              removing strings reuses the same bytes, so its arena only
+ *              grows with the most strings it held at once.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+#define FIRST_SIZE 256 // bytes in the first chunk
+#define CHUNK_SIZE (1<<20) // largest chunk allocated for short strings
+#define SMALL_SIZE 128 // blocks up to this size come in steps of 8 bytes
+#define CLASSES 48 // size classes with a free list, up to 2^39 bytes
+
+typedef struct chunk {
+    struct chunk *next;
+    size_t used;
+    size_t size;
+    char data[]; // string storage follows the header
+} CHUNK; // block of string storage
+
+typedef struct arena {
+    CHUNK *head; // newest chunk, the only one with room in use
+    size_t next; // size of the next chunk
+    char *free[CLASSES]; // freed blocks of each size class
+} ARENA; // declare ARENA struct
+
+static int sizeClass(size_t size) { // O(1)
+    if (size<=SMALL_SIZE) return size>0?(size-1)/8:0;
+    int c=SMALL_SIZE/8;
+    size_t cap=2*SMALL_SIZE;
+    while (cap<size) {
+        cap*=2;
+        c++;
+    }
+    return c;
+} // size class of a block of size bytes
+
+static size_t classSize(int c) { // O(1)
+    return c<SMALL_SIZE/8?(size_t)(c+1)*8:(size_t)2*SMALL_SIZE<<(c-SMALL_SIZE/8);
+} // bytes in a block of class c
+
+ARENA *createArena(void) { // O(1)
+    ARENA *ap=malloc(sizeof(ARENA));
+    assert(ap!=NULL);
+    ap->head=NULL;
+    ap->next=FIRST_SIZE;
+    memset(ap->free,0,sizeof(ap->free));
+    return ap;
+} // create an empty ARENA; no chunk is allocated until the first string
+
+void destroyArena(ARENA *ap) { // O(chunks)
+    assert(ap!=NULL);
+    CHUNK *cp,*next;
+    for (cp=ap->head; cp!=NULL; cp=next) {
+        next=cp->next;
+        free(cp);
+    } // free every chunk
+    free(ap);
+} // free ap and every string copied into it
+
+char *copyString(ARENA *ap, char *str, size_t len) { // O(k)
+    assert(ap!=NULL && str!=NULL);
+    int c=sizeClass(len+1);
+    size_t block=c<CLASSES?classSize(c):len+1;
+    char *copy;
+    if (c<CLASSES && ap->free[c]!=NULL) {
+        copy=ap->free[c];
+        memcpy(&ap->free[c],copy,sizeof(char*)); // unlink it
+    } else {
+        CHUNK *cp=ap->head;
+        if (cp==NULL || cp->size-cp->used<block) {
+            size_t size=block>ap->next?block:ap->next;
+            cp=malloc(sizeof(CHUNK)+size);
+            assert(cp!=NULL);
+            cp->size=size;
+            cp->used=0;
+            cp->next=ap->head;
+            ap->head=cp;
+            if (ap->next<CHUNK_SIZE) ap->next*=2;
+        } // start a new chunk if the block doesn't fit
+        copy=cp->data+cp->used;
+        cp->used+=block;
+    } // reuse a freed block of the same class if there is one
+    memcpy(copy,str,len);
+    copy[len]='\0';
+    return copy;
+} // copy the first len characters of str into ap as a C string
+
+void freeString(ARENA *ap, char *str) { // O(k)
+    assert(ap!=NULL && str!=NULL);
+    int c=sizeClass(strlen(str)+1);
+    if (c>=CLASSES) return; // too big to reuse; freed with the ARENA
+    memcpy(str,&ap->free[c],sizeof(char*));
+    ap->free[c]=str;
+} // give back the block of a string copied into ap, for copyString to reuse
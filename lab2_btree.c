@@ -0,0 +1,298 @@
+/*
+ * File:        btree.c
+ *
+ * Description: This file contains the functions for the "set.h" header file
+ *
+ *              The program will create the abstract data type SET, which
+ *              keeps its strings in sorted order in a B+tree. Every string is
+ *              in a leaf; internal nodes hold their own copies of the first
+ *              string of each child after the first, to steer the search.
+ *              A separator can outlive the leaf string it was copied from,
+ *              so it must not share that string's bytes. The leaves are
+ *              linked in order, so getElements and visitElements just walk
+ *              the chain.
+ *
+ *              Each node holds up to ORDER keys, about half a kilobyte, so a
+ *              search touches a few cache lines per level. Next to each key
+ *              pointer the node keeps the key's first 8 bytes packed
+ *              big-endian into an integer. Comparing those integers orders
+ *              keys the same way strcmp would, so a search only follows a
+ *              pointer to the string itself when the first 8 bytes tie.
+ *
+ *              Removal is lazy: nodes are allowed to run below half full
+ *              and are only freed once they are empty, which keeps removes
+ *              simple and still O(log n) deep. Like the other growable SETs,
+ *              maxElts is only a hint and adds are never dropped. Strings are
+ *              copied into an ARENA owned by the SET, and the bytes of a
+ *              removed string or separator go back to it.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "set.h"
+
+#define ORDER 32 // keys per node
+
+typedef unsigned long long PREFIX;
+
+typedef struct node {
+  int count; // keys in use; an internal node has count+1 children
+  bool leaf;
+  PREFIX prefix[ORDER]; // first 8 bytes of each key
+  char *keys[ORDER];
+  struct node *prev; // leaves: neighbours in order
+  struct node *next;
+  struct node *child[]; // internal nodes only
+} NODE; // declare NODE structure
+
+typedef struct set {
+  NODE *root;
+  int count;
+  ARENA *strings; // storage for the strings in the leaves
+} SET; // declare SET structure
+
+static PREFIX prefixOf(char *str) {
+  PREFIX prefix=0;
+  int i;
+  for (i=0; i<8; i++) {
+    prefix<<=8;
+    if (*str!='\0') prefix|=(unsigned char)*str++;
+  } // pad short strings with zero bytes
+  return prefix;
+} // first 8 bytes of str, big-endian
+
+static int compareKey(PREFIX prefix, char *str, NODE *np, int i) {
+  if (prefix!=np->prefix[i]) return prefix<np->prefix[i]?-1:1;
+  if ((prefix&0xff)==0) return 0; // both strings ended within 8 bytes
+  return strcmp(str+8,np->keys[i]+8);
+} // compare str with key i of np
+
+static int lowerKey(NODE *np, PREFIX prefix, char *str) {
+  int lo=0,hi=np->count,mid;
+  while (lo<hi) {
+    mid=(lo+hi)/2;
+    if (compareKey(prefix,str,np,mid)>0) lo=mid+1;
+    else hi=mid;
+  }
+  return lo;
+} // index of the first key at least str
+
+static int upperKey(NODE *np, PREFIX prefix, char *str) {
+  int lo=0,hi=np->count,mid;
+  while (lo<hi) {
+    mid=(lo+hi)/2;
+    if (compareKey(prefix,str,np,mid)>=0) lo=mid+1;
+    else hi=mid;
+  }
+  return lo;
+} // index of the first key past str: the child to descend into
+
+static NODE *createNode(bool leaf) {
+  NODE *np=malloc(sizeof(NODE)+(leaf?0:sizeof(NODE*)*(ORDER+1)));
+  assert(np!=NULL);
+  np->count=0;
+  np->leaf=leaf;
+  np->prev=NULL;
+  np->next=NULL;
+  return np;
+} // allocate an empty node
+
+static void destroyNode(NODE *np) {
+  int i;
+  if (!np->leaf) for (i=0; i<=np->count; i++) destroyNode(np->child[i]);
+  free(np);
+} // free np and everything below it
+
+static void putKey(NODE *np, int i, PREFIX prefix, char *key) {
+  memmove(np->prefix+i+1,np->prefix+i,sizeof(PREFIX)*(np->count-i));
+  memmove(np->keys+i+1,np->keys+i,sizeof(char*)*(np->count-i));
+  np->prefix[i]=prefix;
+  np->keys[i]=key;
+  np->count++;
+} // insert a key at index i of a node with room
+
+static void moveKeys(NODE *to, NODE *from, int start) {
+  to->count=from->count-start;
+  memcpy(to->prefix,from->prefix+start,sizeof(PREFIX)*to->count);
+  memcpy(to->keys,from->keys+start,sizeof(char*)*to->count);
+  from->count=start;
+} // move keys from index start on into the empty node to
+
+static NODE *insert(SET *sp, NODE *np, PREFIX prefix, char *elt, PREFIX *upPrefix, char **upKey) {
+  int i;
+  NODE *right;
+  if (np->leaf) {
+    i=lowerKey(np,prefix,elt);
+    if (i<np->count && compareKey(prefix,elt,np,i)==0) return NULL; // already there
+    char *copy=copyString(sp->strings,elt,strlen(elt));
+    sp->count++;
+    if (np->count<ORDER) {
+      putKey(np,i,prefix,copy);
+      return NULL;
+    } // room in the leaf
+    right=createNode(true);
+    moveKeys(right,np,ORDER/2);
+    right->next=np->next;
+    right->prev=np;
+    if (np->next!=NULL) np->next->prev=right;
+    np->next=right; // link the new leaf into the chain
+    if (i<=ORDER/2) putKey(np,i,prefix,copy);
+    else putKey(right,i-ORDER/2,prefix,copy);
+    *upPrefix=right->prefix[0];
+    *upKey=copyString(sp->strings,right->keys[0],strlen(right->keys[0]));
+    return right;
+  } // split a full leaf in half
+  i=upperKey(np,prefix,elt);
+  PREFIX sepPrefix;
+  char *sepKey;
+  NODE *child=insert(sp,np->child[i],prefix,elt,&sepPrefix,&sepKey);
+  if (child==NULL) return NULL; // no split below
+  if (np->count<ORDER) {
+    putKey(np,i,sepPrefix,sepKey);
+    memmove(np->child+i+2,np->child+i+1,sizeof(NODE*)*(np->count-i-1));
+    np->child[i+1]=child;
+    return NULL;
+  } // room for the new child
+  PREFIX prefixes[ORDER+1];
+  char *keys[ORDER+1];
+  NODE *children[ORDER+2];
+  memcpy(prefixes,np->prefix,sizeof(PREFIX)*i);
+  memcpy(keys,np->keys,sizeof(char*)*i);
+  prefixes[i]=sepPrefix;
+  keys[i]=sepKey;
+  memcpy(prefixes+i+1,np->prefix+i,sizeof(PREFIX)*(ORDER-i));
+  memcpy(keys+i+1,np->keys+i,sizeof(char*)*(ORDER-i));
+  memcpy(children,np->child,sizeof(NODE*)*(i+1));
+  children[i+1]=child;
+  memcpy(children+i+2,np->child+i+1,sizeof(NODE*)*(ORDER-i)); // all ORDER+1 keys in order
+  int mid=(ORDER+1)/2;
+  right=createNode(false);
+  np->count=mid;
+  memcpy(np->prefix,prefixes,sizeof(PREFIX)*mid);
+  memcpy(np->keys,keys,sizeof(char*)*mid);
+  memcpy(np->child,children,sizeof(NODE*)*(mid+1));
+  right->count=ORDER-mid;
+  memcpy(right->prefix,prefixes+mid+1,sizeof(PREFIX)*right->count);
+  memcpy(right->keys,keys+mid+1,sizeof(char*)*right->count);
+  memcpy(right->child,children+mid+1,sizeof(NODE*)*(right->count+1));
+  *upPrefix=prefixes[mid];
+  *upKey=keys[mid];
+  return right;
+} // add elt below np, returning the new right sibling and its separator if np split
+
+static bool removeKey(SET *sp, NODE *np, PREFIX prefix, char *elt) {
+  int i;
+  if (np->leaf) {
+    i=lowerKey(np,prefix,elt);
+    if (i==np->count || compareKey(prefix,elt,np,i)!=0) return false; // not there
+    freeString(sp->strings,np->keys[i]);
+    memmove(np->prefix+i,np->prefix+i+1,sizeof(PREFIX)*(np->count-i-1));
+    memmove(np->keys+i,np->keys+i+1,sizeof(char*)*(np->count-i-1));
+    np->count--;
+    sp->count--;
+    if (np->count>0 || np==sp->root) return false;
+    if (np->prev!=NULL) np->prev->next=np->next;
+    if (np->next!=NULL) np->next->prev=np->prev;
+    return true;
+  } // unlink an empty leaf from the chain
+  i=upperKey(np,prefix,elt);
+  if (!removeKey(sp,np->child[i],prefix,elt)) return false;
+  free(np->child[i]);
+  if (np->count==0) return true; // that was the only child
+  int k=i>0?i-1:0; // separator next to the child
+  freeString(sp->strings,np->keys[k]);
+  memmove(np->prefix+k,np->prefix+k+1,sizeof(PREFIX)*(np->count-k-1));
+  memmove(np->keys+k,np->keys+k+1,sizeof(char*)*(np->count-k-1));
+  memmove(np->child+i,np->child+i+1,sizeof(NODE*)*(np->count-i));
+  np->count--;
+  return false;
+} // remove elt below np, returning true if np is now empty and should be freed
+
+static NODE *firstLeaf(SET *sp) {
+  NODE *np=sp->root;
+  while (!np->leaf) np=np->child[0];
+  return np;
+} // leftmost leaf
+
+SET *createSet(int maxElts) { // O(1)
+  (void)maxElts; // nodes are allocated as the tree grows, so no size is needed
+  SET *sp=malloc(sizeof(SET));
+  assert(sp!=NULL);
+  sp->root=createNode(true);
+  sp->count=0;
+  sp->strings=createArena();
+  return sp;
+} // create an empty SET
+
+void destroySet(SET *sp) { // O(n)
+  assert(sp!=NULL);
+  destroyNode(sp->root);
+  destroyArena(sp->strings); // free all elements
+  free(sp);
+}
+
+int numElements(SET *sp) { // O(1)
+  assert(sp!=NULL);
+  return sp->count;
+}
+
+void addElement(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL && elt!=NULL);
+  PREFIX upPrefix;
+  char *upKey;
+  NODE *right=insert(sp,sp->root,prefixOf(elt),elt,&upPrefix,&upKey);
+  if (right==NULL) return;
+  NODE *root=createNode(false);
+  root->count=1;
+  root->prefix[0]=upPrefix;
+  root->keys[0]=upKey;
+  root->child[0]=sp->root;
+  root->child[1]=right;
+  sp->root=root;
+} // add elt, growing a new root if the old one split
+
+void removeElement(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL && elt!=NULL);
+  if (removeKey(sp,sp->root,prefixOf(elt),elt)) {
+    free(sp->root);
+    sp->root=createNode(true);
+    return;
+  } // the whole tree emptied
+  while (!sp->root->leaf && sp->root->count==0) {
+    NODE *np=sp->root;
+    sp->root=np->child[0];
+    free(np);
+  } // drop roots with a single child
+}
+
+char *findElement(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL && elt!=NULL);
+  PREFIX prefix=prefixOf(elt);
+  NODE *np=sp->root;
+  while (!np->leaf) np=np->child[upperKey(np,prefix,elt)];
+  int i=lowerKey(np,prefix,elt);
+  return i<np->count && compareKey(prefix,elt,np,i)==0?np->keys[i]:NULL; // return string that matches elt if found, else return NULL
+}
+
+char **getElements(SET *sp) { // O(n)
+  assert(sp!=NULL);
+  char **arr=malloc(sizeof(char*)*(sp->count>0?sp->count:1)); // array of size count
+  assert(arr!=NULL);
+  NODE *np;
+  int num=0;
+  for (np=firstLeaf(sp); np!=NULL; np=np->next) {
+    memcpy(arr+num,np->keys,sizeof(char*)*np->count);
+    num+=np->count;
+  } // walk the leaves in order
+  return arr;
+}
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) { // O(n)
+  assert(sp!=NULL && visit!=NULL);
+  NODE *np;
+  int i;
+  for (np=firstLeaf(sp); np!=NULL; np=np->next) for (i=0; i<np->count; i++) visit(np->keys[i],arg);
+} // call visit on each element in order; visit must not change sp
@@ -0,0 +1,227 @@
+/*
+ * File:        gapped.c
+ *
+ * Description: This file contains the functions for the "set.h" header file
+ *
+ *              The program will create the abstract data type SET, which
+ *              keeps its strings in sorted order in an array with gaps (NULL
+ *              slots) spread through it, a packed-memory array. An insert
+ *              usually finds a gap next to where the string belongs, so
+ *              instead of shifting everything above it, only a small window
+ *              around it is respread, for amortized O(log^2 n) moves.
+ *
+ *              The array is divided into leaf windows of about log n slots,
+ *              and each window belongs to one twice its size, up to the whole
+ *              array. A window of level d may be at most upper(d) full after
+ *              an insert and at least lower(d) full after a remove. The limits
+ *              tighten towards the whole array (from 1 to 3/4 and from 1/8 to
+ *              1/4). When a window goes past its limit, the smallest
+ *              enclosing window within its own limit has its strings spread
+ *              out evenly. If even the whole array is past its limit, it
+ *              doubles or halves, never below the size picked for maxElts.
+ *
+ *              The binary search skips over gaps, which are never long since
+ *              every window keeps its density. Like the other growable SETs,
+ *              maxElts is only a hint and adds are never dropped. Strings are
+ *              copied into an ARENA owned by the SET, and a removed string's
+ *              bytes go back to it.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "set.h"
+
+#define MIN_LENGTH 8
+
+typedef struct set {
+  char **data; // sorted strings, with NULL for gaps
+  char **scratch; // room to gather the strings of a window
+  int length; // slots in data, a power of two
+  int count;
+  int segment; // slots in a leaf window, a power of two
+  int levels; // window levels above the leaves
+  int minLength; // never shrink below this
+  ARENA *strings; // storage for the strings in data
+} SET; // declare SET structure
+
+static double upper(SET *sp, int level) {
+  return sp->levels>0?1.0-0.25*level/sp->levels:0.75;
+} // most a window may be filled
+
+static double lower(SET *sp, int level) {
+  return sp->levels>0?0.125+0.125*level/sp->levels:0.25;
+} // least a window may be filled
+
+static void setLength(SET *sp, int length) {
+  int lg=0;
+  while ((1<<lg)<length) lg++; // log2 of length
+  sp->segment=1;
+  while (sp->segment*2<=lg) sp->segment*=2; // about log n slots per leaf
+  sp->levels=0;
+  while ((sp->segment<<sp->levels)<length) sp->levels++;
+  sp->length=length;
+  sp->scratch=realloc(sp->scratch,sizeof(char*)*(length+1));
+  assert(sp->scratch!=NULL);
+} // set length and the window sizes that go with it
+
+static int search(SET *sp, char *elt, bool *found) { // O(logn)
+  int lo=0,hi=sp->length;
+  int best=sp->length; // first string past elt seen so far
+  int mid,i,comp;
+  *found=false;
+  while (lo<hi) {
+    mid=(lo+hi)/2;
+    for (i=mid; i<hi && sp->data[i]==NULL; i++); // skip a gap
+    if (i==hi) {
+      hi=mid;
+      continue;
+    } // only gaps in [mid,hi)
+    comp=strcmp(elt,sp->data[i]);
+    if (comp==0) {
+      *found=true;
+      return i;
+    } // return i if the string there is elt
+    if (comp<0) {
+      best=i;
+      hi=mid;
+    } else lo=i+1;
+  }
+  return best;
+} // index of elt if found, else of the first string after it (or length)
+
+static int countWindow(SET *sp, int start, int width) {
+  int i,num=0;
+  for (i=start; i<start+width; i++) if (sp->data[i]!=NULL) num++;
+  return num;
+} // number of strings in a window
+
+static int gather(SET *sp, int start, int width, int pos, char *elt) {
+  int i,num=0;
+  for (i=start; i<start+width; i++) {
+    if (i==pos && elt!=NULL) sp->scratch[num++]=elt;
+    if (sp->data[i]!=NULL) sp->scratch[num++]=sp->data[i];
+  } // strings of the window in order, with elt before index pos
+  if (pos>=start+width && elt!=NULL) sp->scratch[num++]=elt;
+  return num;
+} // copy the strings of a window into scratch, adding elt at pos if not NULL
+
+static void spread(char **data, int start, int width, char **items, int num) {
+  int i;
+  memset(data+start,0,sizeof(char*)*width);
+  for (i=0; i<num; i++) data[start+(long long)i*width/num]=items[i];
+} // place num strings evenly through a window
+
+static void resize(SET *sp, int length, int pos, char *elt) {
+  int num=gather(sp,0,sp->length,pos,elt);
+  free(sp->data);
+  sp->data=malloc(sizeof(char*)*length);
+  assert(sp->data!=NULL);
+  setLength(sp,length);
+  spread(sp->data,0,length,sp->scratch,num);
+} // move every string (and elt, if not NULL) into an array of size length
+
+SET *createSet(int maxElts) { // O(m)
+  SET *sp=malloc(sizeof(SET));
+  assert(sp!=NULL);
+  int length=MIN_LENGTH;
+  while (length*3<maxElts*4) length*=2; // maxElts fit without growing
+  sp->data=calloc(length,sizeof(char*));
+  assert(sp->data!=NULL); // every slot a gap
+  sp->scratch=NULL;
+  setLength(sp,length);
+  sp->count=0;
+  sp->minLength=length;
+  sp->strings=createArena();
+  return sp;
+} // create SET expecting about maxElts strings
+
+void destroySet(SET *sp) { // O(1)
+  assert(sp!=NULL);
+  destroyArena(sp->strings); // free all elements in data
+  free(sp->data);
+  free(sp->scratch);
+  free(sp);
+}
+
+int numElements(SET *sp) { // O(1)
+  assert(sp!=NULL);
+  return sp->count;
+}
+
+void addElement(SET *sp, char *elt) { // O(log^2 n) amortized
+  assert(sp!=NULL);
+  bool found;
+  int pos=search(sp,elt,&found);
+  if (found) return; // return if elt already exists
+  char *copy=copyString(sp->strings,elt,strlen(elt));
+  sp->count++;
+  if (sp->count>sp->length*upper(sp,sp->levels)) {
+    resize(sp,sp->length*2,pos,copy);
+    return;
+  } // the whole array is too full
+  int level,start,width=sp->segment;
+  if (pos>0 && sp->data[pos-1]==NULL && countWindow(sp,(pos-1)/width*width,width)+1<=width*upper(sp,0)) {
+    sp->data[pos-1]=copy;
+    return;
+  } // a gap right where elt belongs, in a leaf with room
+  int slot=pos<sp->length?pos:sp->length-1;
+  for (level=0; level<=sp->levels; level++, width*=2) {
+    start=slot/width*width;
+    if (countWindow(sp,start,width)+1<=width*upper(sp,level)) break;
+  } // smallest window with room
+  if (level>sp->levels) {
+    resize(sp,sp->length*2,pos,copy);
+    return;
+  } // the whole array is too full
+  spread(sp->data,start,width,sp->scratch,gather(sp,start,width,pos,copy));
+}
+
+void removeElement(SET *sp, char *elt) { // O(log^2 n) amortized
+  assert(sp!=NULL);
+  bool found;
+  int pos=search(sp,elt,&found);
+  if (!found) return;
+  freeString(sp->strings,sp->data[pos]);
+  sp->data[pos]=NULL; // leave a gap
+  sp->count--;
+  if (sp->length>sp->minLength && sp->count<sp->length*lower(sp,sp->levels)) {
+    resize(sp,sp->length/2,0,NULL);
+    return;
+  } // the whole array is too empty
+  int level,start,width=sp->segment;
+  for (level=0; level<=sp->levels; level++, width*=2) {
+    start=pos/width*width;
+    if (countWindow(sp,start,width)>=width*lower(sp,level)) break;
+  } // smallest window full enough
+  if (level==0) return; // the leaf is still full enough
+  if (level>sp->levels) {
+    width=sp->length;
+    start=0;
+  } // respread everything
+  spread(sp->data,start,width,sp->scratch,gather(sp,start,width,0,NULL));
+}
+
+char *findElement(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL);
+  bool found;
+  int loc=search(sp,elt,&found);
+  return found?sp->data[loc]:NULL; // return string that matches elt if found, else return NULL
+}
+
+char **getElements(SET *sp) { // O(m)
+  assert(sp!=NULL);
+  char **arr=malloc(sizeof(char*)*(sp->count>0?sp->count:1)); // array of size count
+  assert(arr!=NULL);
+  int i,num=0;
+  for (i=0; i<sp->length; i++) if (sp->data[i]!=NULL) arr[num++]=sp->data[i]; // skip gaps
+  return arr;
+}
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) { // O(m)
+  assert(sp!=NULL && visit!=NULL);
+  int i;
+  for (i=0; i<sp->length; i++) if (sp->data[i]!=NULL) visit(sp->data[i],arg);
+} // call visit on each element in order; visit must not change sp
@@ -9,6 +9,68 @@
  *              functions can then be used to add/remove elements to/from the
  *              array, get the amount of elements currently in the array,
  *              check if an element is in the array, and delete the entire SET.
+ *
+ *              By default the SET holds at most maxElts strings and further
+ *              adds are ignored. After setAutoGrow the array doubles whenever
+ *              it fills up, and if shrink is true it halves (never below
+ *              maxElts) once fewer than a quarter of the slots are used.
+ *              reserveSet makes room for n strings up front.
+ *
+ *              Strings are copied into an ARENA owned by the SET rather than
+ *              strdup'ed one at a time, so making room for an insert is one
+ *              memmove of pointers. A removed string's bytes go back to the
+ *              ARENA for the next string of about the same length.
+ *
+ *              visitElements calls a function on each string in order and
+ *              viewElements returns the sorted array itself, so reading every
+ *              element needs no copy. The view is read-only and only good
+ *              until the SET next changes.
+ *
+ *              For sets that are read far more than they change, buildIndex
+ *              makes a copy of the array in Eytzinger order: the middle
+ *              string first, then the middles of each half, and so on, as in
+ *              a binary heap. Each entry holds the string's first 8 bytes
+ *              packed big-endian, which compare as integers the same way the
+ *              strings do, so findElement only follows a pointer to a string
+ *              when the first 8 bytes tie. The search loop has no branches
+ *              to mispredict and prefetches entries four levels ahead. An
+ *              unbuffered add or remove drops the index until buildIndex is
+ *              called again. A buffered SET keeps its index, rebuilding it
+ *              each time the delta is merged.
+ *
+ *              createSetFrom builds a SET from a whole array of strings at
+ *              once. The array is cut into one run per core, each thread
+ *              sorts its run, and pairs of runs are merged by separate
+ *              threads until one run is left. Duplicates are then adjacent
+ *              and are dropped while the strings are copied in, so the build
+ *              costs O(n log n / p) plus a last O(n) merge and copy.
+ *
+ *              lowerBound and upperBound turn the binary search into index
+ *              bounds on the array returned by viewElements, so a range of
+ *              strings is a span of that array and needs no copying.
+ *              rangeCount counts the strings in [lo,hi) and prefixScan visits
+ *              the strings that start with a prefix, in O(log n + k).
+ *
+ *              setUnion, setIntersect, and setDifference merge two SETs into
+ *              a new one in one pass, since both arrays are already in order.
+ *              When one SET is many times the size of the other, the merge
+ *              gallops: it skips through the bigger one by doubling steps and
+ *              then a binary search, so intersecting a small SET with a big
+ *              one costs O(m log(n/m)) rather than O(n). Big merges are split
+ *              across threads at strings of the bigger SET and their
+ *              positions in the other, so each thread merges its own part.
+ *              setIsSubset walks the smaller SET the same way.
+ *
+ *              After setBuffered, adds and removes go to a small sorted delta
+ *              array instead of shifting the main one. A removal of a string
+ *              in the main array is kept in the delta as a tombstone. Lookups
+ *              check the delta and then the main array. Once the delta holds
+ *              limit strings, it is merged into the main array in one linear
+ *              pass, which makes an add cost O(log n + limit) plus an
+ *              amortized O(n/limit) share of the merge. Anything that reads
+ *              the array directly (views, spans, iteration, set algebra, and
+ *              buildIndex) merges the delta first. A limit of 0 merges the
+ *              delta and turns buffering off again.
  */
 
 #include <assert.h>
@@ -16,11 +78,56 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "arena.h"
+#include "set.h"
+
+#define UNION 0 // operations for mergeSpan
+#define INTERSECT 1
+#define DIFFERENCE 2
+#define GALLOP_RATIO 8 // gallop when one side is this many times the other
+#define SPLIT_SIZE (1<<16) // strings per merging thread
+
+typedef unsigned long long PREFIX;
+
+typedef struct entry {
+  PREFIX prefix; // first 8 bytes of key
+  char *key;
+} ENTRY; // string in the Eytzinger index
+
+typedef struct run {
+  char **src;
+  char **dst;
+  int lo; // sort src[lo..hi), or merge src[lo..mid) and src[mid..hi) into dst
+  int mid;
+  int hi;
+} RUN; // work for one sorting thread
+
+typedef struct span {
+  char **a; // merge a[0..na) and b[0..nb) into out
+  int na;
+  char **b;
+  int nb;
+  int op;
+  char **out;
+  int count; // strings written to out
+} SPAN; // work for one merging thread
 
 typedef struct set {
   char **data;
   int length;
   int count;
+  int minLength; // never shrink below this
+  bool grow; // double when full instead of ignoring adds
+  bool shrink; // halve when a quarter full
+  ARENA *strings; // storage for the strings in data
+  ENTRY *index; // data in Eytzinger order from index[1], or NULL
+  char **delta; // strings added or removed since the last merge, in order
+  bool *dead; // dead[i] if delta[i] was removed from data (a tombstone)
+  int deltaCount;
+  int deltaLimit; // merge once the delta holds this many; 0 if unbuffered
+  int net; // adds minus tombstones in delta
 } SET; // declare SET structure
 
 static int search(SET *sp, char *elt, bool *found) { // O(logn)
@@ -54,6 +161,210 @@ static int search(SET *sp, char *elt, bool *found) { // O(logn)
   return lo;
 }
 
+static void resize(SET *sp, int length) { // O(n)
+  sp->data = realloc(sp->data,sizeof(char*)*length);
+  assert(sp->data!=NULL); //ensure realloc was successful
+  sp->length=length;
+} // change the capacity of sp to length; must be at least count
+
+static PREFIX prefixOf(char *str) {
+  PREFIX prefix=0;
+  int i;
+  for (i=0; i<8; i++) {
+    prefix<<=8;
+    if (*str!='\0') prefix|=(unsigned char)*str++;
+  } // pad short strings with zero bytes
+  return prefix;
+} // first 8 bytes of str, big-endian
+
+static int fillIndex(SET *sp, int i, int k) { // O(n)
+  if (k>sp->count) return i;
+  i=fillIndex(sp,i,2*k); // left subtree holds the smaller strings
+  sp->index[k].prefix=prefixOf(sp->data[i]);
+  sp->index[k].key=sp->data[i];
+  return fillIndex(sp,i+1,2*k+1);
+} // put data[i..] into the subtree at k in order, returning the next i
+
+static void makeIndex(SET *sp) { // O(n)
+  free(sp->index);
+  sp->index=malloc(sizeof(ENTRY)*(sp->count+1));
+  assert(sp->index!=NULL);
+  fillIndex(sp,0,1);
+} // (re)build the index from data
+
+static void dropIndex(SET *sp) { // O(1)
+  free(sp->index);
+  sp->index=NULL;
+} // forget the index once data changes
+
+static char *searchIndex(SET *sp, char *elt) { // O(logn)
+  PREFIX prefix=prefixOf(elt);
+  bool tail=(prefix&0xff)!=0; // elt goes past 8 bytes
+  ENTRY *index=sp->index;
+  int n=sp->count;
+  int k=1;
+  while (k<=n) {
+    __builtin_prefetch(index+16*k); // the 16 entries four levels down are adjacent
+    ENTRY *ep=index+k;
+    int less=ep->prefix<prefix || (ep->prefix==prefix && tail && strcmp(ep->key+8,elt+8)<0);
+    k=2*k+less;
+  } // descend without branching on the comparison
+  k>>=__builtin_ffs(~k); // undo the right turns after the last left turn
+  if (k==0 || index[k].prefix!=prefix) return NULL; // every string is smaller, or the next one differs
+  if (tail && strcmp(index[k].key+8,elt+8)!=0) return NULL;
+  return index[k].key;
+} // find elt through the index
+
+static int compareStrings(const void *a, const void *b) {
+  return strcmp(*(char**)a,*(char**)b);
+} // order for qsort
+
+static bool startThread(pthread_t *tid, void *(*work)(void*), void *arg) {
+  if (pthread_create(tid,NULL,work,arg)==0) return true;
+  work(arg);
+  return false;
+} // run work on a new thread, or here if none can be started; true if tid needs joining
+
+static void *sortRun(void *arg) { // O(nlogn)
+  RUN *rp=arg;
+  qsort(rp->src+rp->lo,rp->hi-rp->lo,sizeof(char*),compareStrings);
+  return NULL;
+} // sort one run in place
+
+static void *mergeRuns(void *arg) { // O(n)
+  RUN *rp=arg;
+  int i=rp->lo,j=rp->mid,k=rp->lo;
+  while (i<rp->mid && j<rp->hi) rp->dst[k++]=strcmp(rp->src[i],rp->src[j])<=0?rp->src[i++]:rp->src[j++];
+  while (i<rp->mid) rp->dst[k++]=rp->src[i++];
+  while (j<rp->hi) rp->dst[k++]=rp->src[j++];
+  return NULL;
+} // merge two sorted runs
+
+static char **sortParallel(char **items, int n) { // O(nlogn/p)
+  int threads=sysconf(_SC_NPROCESSORS_ONLN);
+  if (threads>n/4096) threads=n/4096; // not worth a thread below 4096 strings each
+  if (threads<1) threads=1;
+  char **src=malloc(sizeof(char*)*(n>0?n:1));
+  char **dst=malloc(sizeof(char*)*(n>0?n:1));
+  assert(src!=NULL && dst!=NULL);
+  memcpy(src,items,sizeof(char*)*n);
+  RUN *runs=malloc(sizeof(RUN)*threads);
+  pthread_t *tids=malloc(sizeof(pthread_t)*threads);
+  bool *started=malloc(sizeof(bool)*threads);
+  assert(runs!=NULL && tids!=NULL && started!=NULL);
+  int t,step,num;
+  for (t=0; t<threads; t++) {
+    runs[t].src=src;
+    runs[t].lo=(long long)n*t/threads;
+    runs[t].hi=(long long)n*(t+1)/threads;
+    started[t]=startThread(&tids[t],sortRun,&runs[t]);
+  } // sort one run per thread
+  for (t=0; t<threads; t++) if (started[t]) pthread_join(tids[t],NULL);
+  for (step=1; step<threads; step*=2) {
+    num=0;
+    for (t=0; t<threads; t+=2*step) {
+      runs[num].src=src;
+      runs[num].dst=dst;
+      runs[num].lo=(long long)n*t/threads;
+      runs[num].mid=(long long)n*(t+step<threads?t+step:threads)/threads;
+      runs[num].hi=(long long)n*(t+2*step<threads?t+2*step:threads)/threads;
+      started[num]=startThread(&tids[num],mergeRuns,&runs[num]);
+      num++;
+    } // merge pairs of runs, each on its own thread
+    for (t=0; t<num; t++) if (started[t]) pthread_join(tids[t],NULL);
+    char **swap=src;
+    src=dst;
+    dst=swap;
+  } // until one run is left
+  free(dst);
+  free(runs);
+  free(tids);
+  free(started);
+  return src;
+} // sorted copy of items, using every core
+
+static int searchDelta(SET *sp, char *elt, bool *found) { // O(log limit)
+  int lo=0,hi=sp->deltaCount,mid,comp;
+  *found=false;
+  while (lo<hi) {
+    mid=(lo+hi)/2;
+    comp=strcmp(elt,sp->delta[mid]);
+    if (comp==0) {
+      *found=true;
+      return mid;
+    }
+    if (comp>0) lo=mid+1;
+    else hi=mid;
+  }
+  return lo;
+} // index of elt in delta if found, else where it belongs
+
+static void putDelta(SET *sp, int loc, char *elt, bool dead) { // O(limit)
+  memmove(sp->delta+loc+1,sp->delta+loc,sizeof(char*)*(sp->deltaCount-loc));
+  memmove(sp->dead+loc+1,sp->dead+loc,sizeof(bool)*(sp->deltaCount-loc));
+  sp->delta[loc]=elt;
+  sp->dead[loc]=dead;
+  sp->deltaCount++;
+  sp->net+=dead?-1:1;
+} // insert an add or a tombstone into delta at loc
+
+static void takeDelta(SET *sp, int loc) { // O(limit)
+  sp->net-=sp->dead[loc]?-1:1;
+  memmove(sp->delta+loc,sp->delta+loc+1,sizeof(char*)*(sp->deltaCount-loc-1));
+  memmove(sp->dead+loc,sp->dead+loc+1,sizeof(bool)*(sp->deltaCount-loc-1));
+  sp->deltaCount--;
+} // drop entry loc from delta
+
+static int gallop(char **arr, int from, int n, char *key) { // O(log d)
+  if (from>=n || strcmp(arr[from],key)>=0) return from;
+  int step=1;
+  while (from+step<n && strcmp(arr[from+step],key)<0) step*=2; // arr[from+step/2] is before key
+  int lo=from+step/2+1;
+  int hi=from+step<n?from+step:n;
+  int mid;
+  while (lo<hi) {
+    mid=(lo+hi)/2;
+    if (strcmp(arr[mid],key)<0) lo=mid+1;
+    else hi=mid;
+  } // binary search the last step
+  return lo;
+} // index of the first string in arr[from..n) not before key, d places on
+
+static void flush(SET *sp) { // O(n + limit logn)
+  if (sp->deltaCount==0) return;
+  int size=sp->count+sp->net;
+  int length=sp->length;
+  while (length<size) length=length>0?length*2:8; // only a growing SET can need more room
+  char **data=malloc(sizeof(char*)*(length>0?length:1));
+  assert(data!=NULL);
+  int i=0,j,k=0,end;
+  for (j=0; j<sp->deltaCount; j++) {
+    end=gallop(sp->data,i,sp->count,sp->delta[j]);
+    memcpy(data+k,sp->data+i,sizeof(char*)*(end-i));
+    k+=end-i;
+    i=end;
+    if (sp->dead[j]) freeString(sp->strings,sp->data[i++]); // a tombstone drops its string
+    else data[k++]=sp->delta[j];
+  } // copy the run of data before each delta string, then the string itself
+  memcpy(data+k,sp->data+i,sizeof(char*)*(sp->count-i));
+  k+=sp->count-i;
+  free(sp->data);
+  sp->data=data;
+  sp->length=length;
+  sp->count=k;
+  sp->deltaCount=0;
+  sp->net=0;
+  if (sp->shrink) while (sp->count<sp->length/4 && sp->length/2>=sp->minLength) resize(sp,sp->length/2); // halve until over a quarter full
+  if (sp->index!=NULL) makeIndex(sp); // keep an index that was built
+} // merge delta into data in one pass, galloping to each delta string
+
+static char *findData(SET *sp, char *elt) { // O(logn)
+  if (sp->index!=NULL) return searchIndex(sp,elt);
+  bool f=false;
+  int loc=search(sp,elt,&f);
+  return f?sp->data[loc]:NULL;
+} // elt in data, through the index if there is one
+
 SET *createSet(int maxElts) { // O(1)
   SET *sp;
   sp = malloc(sizeof(SET));
@@ -62,61 +373,293 @@ SET *createSet(int maxElts) { // O(1)
   assert(sp->data!=NULL); //ensure malloc was successful
   sp->length=maxElts;
   sp->count=0;
+  sp->minLength=maxElts>8?maxElts:8;
+  sp->grow=false;
+  sp->shrink=false;
+  sp->strings=createArena();
+  sp->index=NULL;
+  sp->delta=NULL;
+  sp->dead=NULL;
+  sp->deltaCount=0;
+  sp->deltaLimit=0;
+  sp->net=0;
   return sp;
 }
 
+SET *createSetFrom(char **items, int n) { // O(nlogn/p)
+  assert(items!=NULL || n==0);
+  SET *sp=createSet(n);
+  char **sorted=sortParallel(items,n);
+  int i;
+  for (i=0; i<n; i++) {
+    if (sp->count>0 && strcmp(sorted[i],sp->data[sp->count-1])==0) continue; // skip duplicates
+    sp->data[sp->count++]=copyString(sp->strings,sorted[i],strlen(sorted[i]));
+  } // copy each distinct string in order
+  free(sorted);
+  return sp;
+} // create SET holding the distinct strings of items, with room for n
+
+void setAutoGrow(SET *sp, bool shrink) { // O(1)
+  assert(sp!=NULL);
+  sp->grow=true;
+  sp->shrink=shrink;
+} // let sp grow past maxElts, and shrink again if shrink is true
+
+void reserveSet(SET *sp, int n) { // O(n)
+  assert(sp!=NULL);
+  if (n>sp->length) resize(sp,n);
+} // make room for at least n elements
+
+void setBuffered(SET *sp, int limit) { // O(n)
+  assert(sp!=NULL && limit>=0);
+  flush(sp);
+  sp->deltaLimit=limit;
+  if (limit==0) {
+    free(sp->delta);
+    free(sp->dead);
+    sp->delta=NULL;
+    sp->dead=NULL;
+    return;
+  } // unbuffered again
+  sp->delta=realloc(sp->delta,sizeof(char*)*limit);
+  sp->dead=realloc(sp->dead,sizeof(bool)*limit);
+  assert(sp->delta!=NULL && sp->dead!=NULL);
+} // buffer up to limit adds and removes before merging them into data, or none if limit is 0
+
+void buildIndex(SET *sp) { // O(n)
+  assert(sp!=NULL);
+  flush(sp);
+  makeIndex(sp);
+} // build the Eytzinger index used by findElement until sp next changes
+
 void destroySet(SET *sp) { // O(n)
   assert(sp!=NULL);
-  int i;
-  for (i=0; i<sp->count; i++) free(sp->data[i]); // free all elements in data
+  destroyArena(sp->strings); // free all elements in data
   free(sp->data);
+  free(sp->index);
+  free(sp->delta);
+  free(sp->dead);
   free(sp);
 }
 
 int numElements(SET *sp) { // O(1)
   assert(sp!=NULL);
-  return sp->count;
+  return sp->count+sp->net;
 }
 
 void addElement(SET *sp, char *elt) { // O(n)
   assert(sp!=NULL);
-  if (sp->count>=sp->length) return;
+  if (sp->deltaLimit>0) {
+    if (sp->count+sp->net>=sp->length && !sp->grow) return;
+    bool f;
+    int loc=searchDelta(sp,elt,&f);
+    if (f) {
+      if (sp->dead[loc]) takeDelta(sp,loc); // cancel the removal
+      return;
+    } // return if elt is already in delta
+    if (findData(sp,elt)!=NULL) return; // return if elt already exists
+    putDelta(sp,loc,copyString(sp->strings,elt,strlen(elt)),false);
+    if (sp->deltaCount>=sp->deltaLimit) flush(sp);
+    return;
+  } // buffered
+  if (sp->count>=sp->length && !sp->grow) return;
   bool f=false;
   int loc;
   loc=search(sp,elt,&f); // set loc to result of search
   if (f) return; // return if elt already exists
-  int i;
-  for (i=sp->count;i>loc; i--) {
-    sp->data[i]=strdup(sp->data[i-1]);
-    free(sp->data[i-1]);
-  } // move each string above loc up one
-  sp->data[loc]=strdup(elt); // copy elt to index loc
+  if (sp->count>=sp->length) resize(sp,sp->length>0?sp->length*2:8); // double when full
+  dropIndex(sp);
+  memmove(sp->data+loc+1,sp->data+loc,sizeof(char*)*(sp->count-loc)); // move each string above loc up one
+  sp->data[loc]=copyString(sp->strings,elt,strlen(elt)); // copy elt to index loc
   sp->count++;
 }
 
 void removeElement(SET *sp, char *elt) { // O(n)
   assert(sp!=NULL);
+  if (sp->deltaLimit>0) {
+    bool f;
+    int loc=searchDelta(sp,elt,&f);
+    if (f) {
+      if (!sp->dead[loc]) {
+        freeString(sp->strings,sp->delta[loc]);
+        takeDelta(sp,loc);
+      } // cancel the add
+      return;
+    } // return if elt is already in delta
+    char *str=findData(sp,elt);
+    if (str==NULL) return; // return if elt does not exist
+    putDelta(sp,loc,str,true);
+    if (sp->deltaCount>=sp->deltaLimit) flush(sp);
+    return;
+  } // buffered
   bool f=false;
   int loc=search(sp,elt,&f);
   if (!f) return;
-  free(sp->data[loc]); // free data at loc
-  int i;
-  //sp->data[loc]=malloc(sizeof(char*));
-  for (i=loc; i<sp->count-1; i++) sp->data[i]=sp->data[i+1]; // move each element above loc down one
+  dropIndex(sp);
+  freeString(sp->strings,sp->data[loc]);
+  memmove(sp->data+loc,sp->data+loc+1,sizeof(char*)*(sp->count-loc-1)); // move each element above loc down one
   sp->data[sp->count-1]=NULL;
   sp->count--;
+  if (sp->shrink && sp->count<sp->length/4 && sp->length/2>=sp->minLength) resize(sp,sp->length/2); // halve when a quarter full
 }
 
 char *findElement(SET *sp, char *elt) { // O(1)
   assert(sp!=NULL);
-  bool f=false;
-  int loc=search(sp,elt,&f);
-  return f?sp->data[loc]:NULL; // return string that matches elt if found, else return NULL
+  if (sp->deltaCount>0) {
+    bool f;
+    int loc=searchDelta(sp,elt,&f);
+    if (f) return sp->dead[loc]?NULL:sp->delta[loc];
+  } // the delta is newer than data
+  return findData(sp,elt); // return string that matches elt if found, else return NULL
 }
 
 char **getElements(SET *sp) { // O(1)
   assert(sp!=NULL);
+  flush(sp);
   char **arr = malloc(sizeof(char*)*sp->count); // array of size count
   memcpy(arr,sp->data,sizeof(char*)*sp->count); // all elements in data into arr
   return arr;
-}
\ No newline at end of file
+}
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) { // O(n)
+  assert(sp!=NULL && visit!=NULL);
+  flush(sp);
+  int i;
+  for (i=0; i<sp->count; i++) visit(sp->data[i],arg);
+} // call visit on each element in order; visit must not change sp
+
+char * const *viewElements(SET *sp) { // O(1)
+  assert(sp!=NULL);
+  flush(sp);
+  return sp->data;
+} // the numElements strings in sp in order, read-only until sp next changes
+
+int lowerBound(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL && elt!=NULL);
+  flush(sp);
+  bool f=false;
+  return search(sp,elt,&f);
+} // index of the first element not before elt
+
+int upperBound(SET *sp, char *elt) { // O(logn)
+  assert(sp!=NULL && elt!=NULL);
+  flush(sp);
+  bool f=false;
+  int loc=search(sp,elt,&f);
+  return f?loc+1:loc;
+} // index of the first element after elt
+
+int rangeCount(SET *sp, char *lo, char *hi) { // O(logn)
+  int num=lowerBound(sp,hi)-lowerBound(sp,lo);
+  return num>0?num:0;
+} // number of elements at least lo and before hi
+
+int prefixScan(SET *sp, char *prefix, void (*visit)(char *elt, void *arg), void *arg) { // O(logn+k)
+  assert(sp!=NULL && prefix!=NULL);
+  flush(sp);
+  size_t len=strlen(prefix);
+  int start=lowerBound(sp,prefix);
+  int i;
+  for (i=start; i<sp->count && strncmp(sp->data[i],prefix,len)==0; i++) if (visit!=NULL) visit(sp->data[i],arg);
+  return i-start;
+} // call visit (if not NULL) on each element starting with prefix, in order, and return how many there are; they start at lowerBound(sp,prefix)
+
+static void *mergeSpan(void *arg) { // O(na+nb), or O(m log(n/m)) galloping
+  SPAN *mp=arg;
+  bool skip=mp->na>GALLOP_RATIO*mp->nb || mp->nb>GALLOP_RATIO*mp->na;
+  int i=0,j=0,k=0,end,comp;
+  while (i<mp->na && j<mp->nb) {
+    comp=strcmp(mp->a[i],mp->b[j]);
+    if (comp<0) {
+      end=skip?gallop(mp->a,i+1,mp->na,mp->b[j]):i+1;
+      if (mp->op!=INTERSECT) while (i<end) mp->out[k++]=mp->a[i++];
+      i=end;
+    } else if (comp>0) {
+      end=skip?gallop(mp->b,j+1,mp->nb,mp->a[i]):j+1;
+      if (mp->op==UNION) while (j<end) mp->out[k++]=mp->b[j++];
+      j=end;
+    } else {
+      if (mp->op!=DIFFERENCE) mp->out[k++]=mp->a[i];
+      i++;
+      j++;
+    } // in both
+  }
+  if (mp->op!=INTERSECT) while (i<mp->na) mp->out[k++]=mp->a[i++];
+  if (mp->op==UNION) while (j<mp->nb) mp->out[k++]=mp->b[j++];
+  mp->count=k;
+  return NULL;
+} // merge two sorted arrays by op
+
+static SET *combine(SET *a, SET *b, int op) { // O(n+m)
+  assert(a!=NULL && b!=NULL);
+  flush(a);
+  flush(b);
+  int size=op==UNION?a->count+b->count:a->count; // most strings the result can hold
+  SET *sp=createSet(size>0?size:1);
+  bool big=a->count>=b->count; // split at strings of the bigger SET
+  SET *lead=big?a:b;
+  SET *other=big?b:a;
+  int parts=(a->count+b->count)/SPLIT_SIZE;
+  int cores=sysconf(_SC_NPROCESSORS_ONLN);
+  if (parts>cores) parts=cores;
+  if (parts<1) parts=1;
+  SPAN *spans=malloc(sizeof(SPAN)*parts);
+  pthread_t *tids=malloc(sizeof(pthread_t)*parts);
+  bool *started=calloc(parts,sizeof(bool));
+  char **out=malloc(sizeof(char*)*(size>0?size:1));
+  assert(spans!=NULL && tids!=NULL && started!=NULL && out!=NULL);
+  int t,i,num=0;
+  int leadStart=0,otherStart=0,leadEnd,otherEnd;
+  for (t=0; t<parts; t++) {
+    leadEnd=t+1<parts?(long long)lead->count*(t+1)/parts:lead->count;
+    otherEnd=t+1<parts?lowerBound(other,lead->data[leadEnd]):other->count; // co-rank of the split string
+    spans[t].a=(big?lead:other)->data+(big?leadStart:otherStart);
+    spans[t].na=big?leadEnd-leadStart:otherEnd-otherStart;
+    spans[t].b=(big?other:lead)->data+(big?otherStart:leadStart);
+    spans[t].nb=big?otherEnd-otherStart:leadEnd-leadStart;
+    spans[t].op=op;
+    spans[t].out=out+(op==UNION?leadStart+otherStart:big?leadStart:otherStart); // room for everything before the part
+    if (parts>1) started[t]=startThread(&tids[t],mergeSpan,&spans[t]);
+    else mergeSpan(&spans[t]);
+    leadStart=leadEnd;
+    otherStart=otherEnd;
+  } // cut both SETs at the same strings
+  for (t=0; t<parts; t++) {
+    if (started[t]) pthread_join(tids[t],NULL);
+    for (i=0; i<spans[t].count; i++) sp->data[num++]=copyString(sp->strings,spans[t].out[i],strlen(spans[t].out[i]));
+  } // copy each part's strings in order
+  sp->count=num;
+  free(spans);
+  free(tids);
+  free(started);
+  free(out);
+  return sp;
+} // new SET holding a op b
+
+SET *setUnion(SET *a, SET *b) { // O(n+m)
+  return combine(a,b,UNION);
+} // new SET of the strings in a or b
+
+SET *setIntersect(SET *a, SET *b) { // O(n+m), or O(m log(n/m)) if sizes differ a lot
+  return combine(a,b,INTERSECT);
+} // new SET of the strings in both a and b
+
+SET *setDifference(SET *a, SET *b) { // O(n+m), or less if sizes differ a lot
+  return combine(a,b,DIFFERENCE);
+} // new SET of the strings in a but not b
+
+bool setIsSubset(SET *a, SET *b) { // O(n+m), or O(n log(m/n)) if b is much bigger
+  assert(a!=NULL && b!=NULL);
+  flush(a);
+  flush(b);
+  if (a->count>b->count) return false;
+  bool skip=b->count>GALLOP_RATIO*a->count;
+  int i,j=0;
+  for (i=0; i<a->count; i++) {
+    if (skip) j=gallop(b->data,j,b->count,a->data[i]);
+    else while (j<b->count && strcmp(b->data[j],a->data[i])<0) j++;
+    if (j==b->count || strcmp(b->data[j],a->data[i])!=0) return false;
+    j++;
+  } // find each string of a in b
+  return true;
+} // true if every string in a is in b
@@ -9,75 +9,374 @@
  *              functions can then be used to add/remove elements to/from the
  *              array, get the amount of elements currently in the array, check
  *              if an element is in the array, and delete the entire SET.
+ *
+ *              Next to the strings the SET keeps an array of their 32-bit
+ *              hashes. A search compares the hash of the string it wants
+ *              against eight stored hashes at a time with SSE2, and only
+ *              calls strcmp on strings whose hash matches.
+ *
+ *              By default the SET holds at most maxElts strings and further
+ *              adds are ignored. After setAutoGrow the arrays double whenever
+ *              they fill up, and if shrink is true they halve (never below
+ *              maxElts) once fewer than a quarter of the slots are used.
+ *              reserveSet makes room for n strings up front.
+ *
+ *              Strings are copied into an ARENA owned by the SET rather than
+ *              strdup'ed one at a time. A removed string's bytes go back to
+ *              the ARENA for the next string of about the same length.
+ *
+ *              addElements and removeElements take a whole batch at once.
+ *              The batch and the current elements are each sorted by hash
+ *              and then string, and one merge over the two finds which
+ *              strings are new or present. That costs O((n+m) log(n+m))
+ *              instead of a linear search per string.
+ *
+ *              After setLazyDedup, addElement appends to the end of data
+ *              without searching, so data[clean..count) is a log that may
+ *              hold duplicates. The log is merged into the set the same way
+ *              as a batch, either when it grows past ratio times the
+ *              deduplicated part or before anything that reads the SET. The
+ *              duplicate copies are given back to the ARENA at that point, so
+ *              they don't use memory for long.
+ *
+ *              A SET made with createOrganizedSet reorders itself as it is
+ *              used. Each string found by findElement (or added again) moves
+ *              to the front of data with MOVE_TO_FRONT, or one place forward
+ *              with TRANSPOSE, so frequently used strings are found early.
+ *              Removals then keep the order. averageScanDepth tells how many
+ *              strings a search looked at on average.
+ *
+ *              visitElements calls a function on each string in place and
+ *              viewElements returns the array itself, so reading every
+ *              element needs no copy. The view is read-only and only good
+ *              until the SET next changes.
  */
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "set.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define LOG_MIN 64 // log length always allowed before a merge
 
 typedef struct set {
     char ** data;
+    unsigned * hash; // hash[i] is the hash of data[i]
     int length;
     int count;
+    int minLength; // never shrink below this
+    bool grow; // double when full instead of ignoring adds
+    bool shrink; // halve when a quarter full
+    ARENA *strings; // storage for the strings in data
+    bool lazy; // append without checking for duplicates
+    double ratio; // merge the log once it is ratio times the rest
+    int clean; // data[0..clean) has no duplicates; the rest is the log
+    int policy; // how a found string is moved forward
+    unsigned long long searches;
+    unsigned long long depth; // total strings looked at by searches
 } SET; //declare SET structure
 
+typedef struct item {
+    unsigned hash;
+    int index; // position in the batch or in data
+    char *str;
+} ITEM; // string being merged into the SET or out of it
+
+static unsigned strhash(char *str) { // O(k)
+    unsigned hash=2166136261u;
+    while (*str!='\0') hash=(hash^(unsigned char)*str++)*16777619u; // 32-bit FNV-1a
+    return hash;
+} // fingerprint of str
+
+static int scan(SET *sp, char *elt) { // O(n)
+    unsigned hash=strhash(elt);
+    int i=0;
+#ifdef __SSE2__
+    __m128i key=_mm_set1_epi32(hash);
+    for (; i+8<=sp->count; i+=8) {
+        __m128i a=_mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(sp->hash+i)),key);
+        __m128i b=_mm_cmpeq_epi32(_mm_loadu_si128((__m128i*)(sp->hash+i+4)),key);
+        unsigned bits=_mm_movemask_ps(_mm_castsi128_ps(a))|_mm_movemask_ps(_mm_castsi128_ps(b))<<4;
+        while (bits!=0) {
+            int j=i+__builtin_ctz(bits);
+            if (strcmp(elt,sp->data[j])==0) return j;
+            bits&=bits-1;
+        } // strcmp only where the hash matched
+    } // eight hashes at a time
+#endif
+    for (; i<sp->count; i++) if (sp->hash[i]==hash && strcmp(elt,sp->data[i])==0) return i; // return i if data[i] is same as elt
+    return -1; // -1 if no match found
+} // index of elt in data
+
 static int search(SET *sp, char *elt) { // O(n)
     assert(sp!=NULL);
-    int i;
-    for (i=0; i<sp->count; i++) if (strcmp(elt,sp->data[i])==0) return i; // return i if data[i] is same as elt
-    return -1; // -1 if no match found
+    int loc=scan(sp,elt);
+    sp->searches++;
+    sp->depth+=loc==-1?sp->count:loc+1; // strings looked at
+    return loc;
 }
 
+static int organize(SET *sp, int loc) { // O(n)
+    int to=loc;
+    if (sp->policy==MOVE_TO_FRONT) to=0;
+    if (sp->policy==TRANSPOSE && loc>0) to=loc-1;
+    char *str=sp->data[loc];
+    unsigned hash=sp->hash[loc];
+    memmove(sp->data+to+1,sp->data+to,sizeof(char*)*(loc-to));
+    memmove(sp->hash+to+1,sp->hash+to,sizeof(unsigned)*(loc-to));
+    sp->data[to]=str;
+    sp->hash[to]=hash;
+    return to;
+} // move the string at loc forward by the SET's policy and return its new index
+
+static void resize(SET *sp, int length) { // O(n)
+    sp->data = realloc(sp->data,sizeof(char*)*length);
+    assert(sp->data!=NULL); // ensure realloc was successful
+    sp->hash = realloc(sp->hash,sizeof(unsigned)*length);
+    assert(sp->hash!=NULL);
+    sp->length=length;
+} // change the capacity of sp to length; must be at least count
+
+static int compareKeys(const ITEM *x, const ITEM *y) { // O(k)
+    if (x->hash!=y->hash) return x->hash<y->hash?-1:1;
+    return strcmp(x->str,y->str);
+} // order by hash, then string
+
+static int compareItems(const void *a, const void *b) { // O(k)
+    int comp=compareKeys(a,b);
+    return comp!=0?comp:((const ITEM*)a)->index-((const ITEM*)b)->index; // earlier copy of a string first
+} // order for qsort
+
+static ITEM *sortItems(char **strs, unsigned *hash, int n) { // O(nlogn)
+    ITEM *items=malloc(sizeof(ITEM)*(n>0?n:1));
+    assert(items!=NULL);
+    int i;
+    for (i=0; i<n; i++) {
+        items[i].hash=hash!=NULL?hash[i]:strhash(strs[i]);
+        items[i].index=i;
+        items[i].str=strs[i];
+    }
+    qsort(items,n,sizeof(ITEM),compareItems);
+    return items;
+} // strs as ITEMs in order, hashing them unless hash is given
+
+static void mergeBatch(SET *sp, char **elts, unsigned *hash, int n, bool *fresh, bool *present) { // O((n+m)log(n+m))
+    ITEM *batch=sortItems(elts,hash,n);
+    ITEM *data=sortItems(sp->data,sp->hash,sp->count);
+    int i,j=0;
+    for (i=0; i<n; i++) {
+        if (i>0 && compareKeys(&batch[i],&batch[i-1])==0) continue; // a later copy in the batch
+        while (j<sp->count && compareKeys(&batch[i],&data[j])>0) j++; // skip smaller elements
+        if (j<sp->count && compareKeys(&batch[i],&data[j])==0) {
+            if (present!=NULL) present[data[j].index]=true;
+        } else if (fresh!=NULL) fresh[batch[i].index]=true;
+    } // one merge over the batch and the elements
+    free(batch);
+    free(data);
+} // mark each first copy in elts not in sp as fresh, and each element of sp in elts as present
+
+static void settle(SET *sp) { // O((n+m)log(n+m))
+    int n=sp->count-sp->clean;
+    if (!sp->lazy || n==0) return;
+    char **log=sp->data+sp->clean;
+    unsigned *hash=sp->hash+sp->clean;
+    bool *fresh=calloc(n,sizeof(bool));
+    assert(fresh!=NULL);
+    sp->count=sp->clean;
+    mergeBatch(sp,log,hash,n,fresh,NULL); // dedupe the log against itself and data[0..clean)
+    int i,num=0;
+    for (i=0; i<n; i++) {
+        if (!fresh[i]) {
+            freeString(sp->strings,log[i]);
+            continue;
+        } // give back a duplicate's bytes
+        log[num]=log[i];
+        hash[num]=hash[i];
+        num++;
+    } // keep first copies of new strings, in order
+    sp->count+=num;
+    sp->clean=sp->count;
+    free(fresh);
+} // merge the log into the rest of data
+
 SET *createSet(int maxElts) { // O(1)
     SET *sp;
     sp = malloc(sizeof(SET));
     assert(sp!=NULL); // ensure malloc was successful
     sp->data = malloc(sizeof(char*)*maxElts);
     assert(sp->data!=NULL); // ensure malloc was successful
+    sp->hash = malloc(sizeof(unsigned)*maxElts);
+    assert(sp->hash!=NULL);
     sp->length=maxElts;
     sp->count=0;
+    sp->minLength=maxElts>8?maxElts:8;
+    sp->grow=false;
+    sp->shrink=false;
+    sp->strings=createArena();
+    sp->lazy=false;
+    sp->ratio=0;
+    sp->clean=0;
+    sp->policy=UNORGANIZED;
+    sp->searches=0;
+    sp->depth=0;
     return sp;
 }
 
+SET *createOrganizedSet(int maxElts, int policy) { // O(1)
+    assert(policy==UNORGANIZED || policy==MOVE_TO_FRONT || policy==TRANSPOSE);
+    SET *sp=createSet(maxElts);
+    sp->policy=policy;
+    return sp;
+} // create a SET that moves strings forward as they are found
+
+double averageScanDepth(SET *sp) { // O(1)
+    assert(sp!=NULL);
+    return sp->searches>0?(double)sp->depth/sp->searches:0;
+} // average number of strings each search looked at
+
+void setAutoGrow(SET *sp, bool shrink) { // O(1)
+    assert(sp!=NULL);
+    sp->grow=true;
+    sp->shrink=shrink;
+} // let sp grow past maxElts, and shrink again if shrink is true
+
+void reserveSet(SET *sp, int n) { // O(n)
+    assert(sp!=NULL);
+    if (n>sp->length) resize(sp,n);
+} // make room for at least n elements
+
+void setLazyDedup(SET *sp, double ratio) { // O(1)
+    assert(sp!=NULL && ratio>0);
+    sp->lazy=true;
+    sp->ratio=ratio;
+    sp->clean=sp->count;
+} // make addElement append without searching, deduplicating later
+
 void destroySet(SET *sp) { // O(n)
     assert(sp!=NULL);
-    int i;
-    for (i=0; i<sp->count; i++) free(sp->data[i]); // free all elements in data
+    destroyArena(sp->strings); // free all elements in data
     free(sp->data);
+    free(sp->hash);
     free(sp);
 }
 
 int numElements(SET *sp) { // O(1)
     assert(sp!=NULL);
+    settle(sp);
     return sp->count;
 }
 
 void addElement(SET *sp, char *elt) { // O(1)
     assert(sp!=NULL);
-    if (sp->count>=sp->length) return; // return if there is no space
-    if (search(sp,elt)!=-1) return; // return if elt already exists
-    sp->data[sp->count]=strdup(elt); // add elt to end
+    if (sp->lazy && sp->count>=sp->length && !sp->grow) settle(sp); // make room by merging the log
+    if (sp->count>=sp->length && !sp->grow) return; // return if there is no space
+    if (!sp->lazy) {
+        int loc=search(sp,elt);
+        if (loc!=-1) {
+            organize(sp,loc);
+            return;
+        } // return if elt already exists
+    }
+    if (sp->count>=sp->length) resize(sp,sp->length>0?sp->length*2:8); // double when full
+    sp->data[sp->count]=copyString(sp->strings,elt,strlen(elt)); // add elt to end
+    sp->hash[sp->count]=strhash(elt);
     sp->count++;
+    if (sp->lazy && sp->count-sp->clean>LOG_MIN && sp->count-sp->clean>sp->ratio*sp->clean) settle(sp); // merge a long log
 }
 
 void removeElement(SET *sp, char *elt) { // O(1)
     assert(sp!=NULL);
+    settle(sp);
     int loc=search(sp,elt);
     if (loc==-1) return; // return if elt does not exist
-    free(sp->data[loc]);
-    sp->data[loc]=sp->data[sp->count-1];
+    freeString(sp->strings,sp->data[loc]);
+    if (sp->policy!=UNORGANIZED) {
+        memmove(sp->data+loc,sp->data+loc+1,sizeof(char*)*(sp->count-loc-1));
+        memmove(sp->hash+loc,sp->hash+loc+1,sizeof(unsigned)*(sp->count-loc-1));
+    } else {
+        sp->data[loc]=sp->data[sp->count-1];
+        sp->hash[loc]=sp->hash[sp->count-1];
+    } // keep the order of an organized SET
     sp->data[sp->count-1]=NULL; // set former location of last element to NULL
     sp->count--;
+    sp->clean=sp->count;
+    if (sp->shrink && sp->count<sp->length/4 && sp->length/2>=sp->minLength) resize(sp,sp->length/2); // halve when a quarter full
 }
 
+void addElements(SET *sp, char **elts, int n) { // O((n+m)log(n+m))
+    assert(sp!=NULL && (elts!=NULL || n==0));
+    bool *fresh=calloc(n>0?n:1,sizeof(bool));
+    assert(fresh!=NULL);
+    settle(sp);
+    mergeBatch(sp,elts,NULL,n,fresh,NULL);
+    int i,num=0;
+    for (i=0; i<n; i++) if (fresh[i]) num++;
+    if (sp->grow && sp->count+num>sp->length) {
+        int length=sp->length>0?sp->length:8;
+        while (length<sp->count+num) length*=2;
+        resize(sp,length);
+    } // grow once for the whole batch
+    for (i=0; i<n && sp->count<sp->length; i++) {
+        if (!fresh[i]) continue;
+        sp->data[sp->count]=copyString(sp->strings,elts[i],strlen(elts[i]));
+        sp->hash[sp->count]=strhash(elts[i]);
+        sp->count++;
+    } // append new strings in batch order until full
+    sp->clean=sp->count;
+    free(fresh);
+} // add every string in elts that is not already in sp
+
+void removeElements(SET *sp, char **elts, int n) { // O((n+m)log(n+m))
+    assert(sp!=NULL && (elts!=NULL || n==0));
+    settle(sp);
+    bool *present=calloc(sp->count>0?sp->count:1,sizeof(bool));
+    assert(present!=NULL);
+    mergeBatch(sp,elts,NULL,n,NULL,present);
+    int i,num=0;
+    for (i=0; i<sp->count; i++) {
+        if (present[i]) {
+            freeString(sp->strings,sp->data[i]);
+            continue;
+        }
+        sp->data[num]=sp->data[i];
+        sp->hash[num]=sp->hash[i];
+        num++;
+    } // keep elements not in the batch, in order
+    sp->count=num;
+    sp->clean=num;
+    free(present);
+    while (sp->shrink && sp->count<sp->length/4 && sp->length/2>=sp->minLength) resize(sp,sp->length/2); // halve until over a quarter full
+} // remove every string in elts from sp
+
 char *findElement(SET *sp, char *elt) { // O(1)
     assert(sp!=NULL);
+    settle(sp);
     int loc = search(sp,elt);
+    if (loc!=-1) loc=organize(sp,loc); // move it forward for next time
     return loc==-1?NULL:sp->data[loc]; // return NULL if elt does not exist, else return the string that matches elt
 }
 
 char **getElements(SET *sp) { // O(1)
-    assert(sp!=NULL);    
+    assert(sp!=NULL);
+    settle(sp);
     char **arr = malloc(sizeof(char*) * sp->count); // array of size count
     memcpy(arr,sp->data,sizeof(char*)*sp->count); // all elements in data into arr
     return arr;
-}
\ No newline at end of file
+}
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) { // O(n)
+    assert(sp!=NULL && visit!=NULL);
+    settle(sp);
+    int i;
+    for (i=0; i<sp->count; i++) visit(sp->data[i],arg);
+} // call visit on each element; visit must not change sp
+
+char * const *viewElements(SET *sp) { // O(1)
+    assert(sp!=NULL);
+    settle(sp);
+    return sp->data;
+} // the numElements strings in sp, read-only until sp next changes
@@ -0,0 +1,241 @@
+/*
+ * File:        adaptive.c
+ *
+ * Description: This file contains the functions for the "set.h" header file
+ *
+ *              The program will create the abstract data type SET, which
+ *              holds strings in whichever of two layouts suits its size. A
+ *              small SET is an unsorted array searched from the front, which
+ *              beats hashing for a handful of strings. Once it holds more
+ *              than threshold strings it is promoted to a hash table with
+ *              linear probing, where the flag array marks each index as
+ *              deleted (-1), unused (0), or filled (1). If demotion is on, a
+ *              table that falls below half the threshold turns back into an
+ *              array.
+ *
+ *              Either way the hash of each string is kept beside it, so
+ *              strcmp is only called on strings whose hash matches. The table
+ *              is rehashed whenever filled and deleted indexes pass three
+ *              quarters of it, so unlike the fixed-size SETs this one never
+ *              fills up; maxElts is only a hint for the first table's size.
+ *              Strings are copied into an ARENA owned by the SET, and a
+ *              removed string's bytes go back to it.
+ *
+ *              visitElements calls a function on each string in place,
+ *              without building an array like getElements.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "set.h"
+
+#define THRESHOLD 16 // promote past this many strings unless told otherwise
+
+typedef struct set {
+  char **data;
+  unsigned *hash; // hash[i] is the hash of data[i]
+  int *flag; // NULL while the SET is an array
+  int length;
+  int count;
+  int deleted; // indexes flagged -1
+  int hint; // maxElts given to createSet
+  int threshold; // most strings kept as an array
+  bool demote; // turn back into an array when small
+  ARENA *strings; // storage for the strings in data
+} SET; // declare SET structure
+
+static unsigned strhash(char *str) {
+  unsigned hash=2166136261u;
+  while (*str!='\0') hash=(hash^(unsigned char)*str++)*16777619u; // 32-bit FNV-1a
+  return hash;
+} // get hash of str
+
+static int search(SET *sp, char *elt, unsigned hash, bool *found) {
+  int i,loc;
+  *found=false;
+  if (sp->flag==NULL) {
+    for (i=0; i<sp->count; i++) {
+      if (sp->hash[i]==hash && strcmp(sp->data[i],elt)==0) {
+        *found=true;
+        return i;
+      }
+    } // scan the array from the front
+    return sp->count; // new strings go at the end
+  } // array
+  int avail=-1; // first deleted index passed
+  loc=hash%sp->length; // home index
+  while (sp->flag[loc]!=0) {
+    if (sp->flag[loc]==-1) {
+      if (avail==-1) avail=loc;
+    } else if (sp->hash[loc]==hash && strcmp(sp->data[loc],elt)==0) {
+      *found=true;
+      return loc;
+    } // return if elt is found
+    loc=(loc+1)%sp->length;
+  } // probe until an unused index; the table is never full
+  return avail==-1?loc:avail;
+} // index of elt if found, else where elt should be inserted
+
+static void allocTable(SET *sp, int length) {
+  sp->data=malloc(sizeof(char*)*length);
+  assert(sp->data!=NULL);
+  sp->hash=malloc(sizeof(unsigned)*length);
+  assert(sp->hash!=NULL);
+  sp->flag=calloc(length,sizeof(int));
+  assert(sp->flag!=NULL); // all indexes unused
+  sp->length=length;
+  sp->deleted=0;
+} // allocate an empty table of size length
+
+static void rehash(SET *sp, int length) {
+  char **data=sp->data;
+  unsigned *hash=sp->hash;
+  int *flag=sp->flag;
+  int old=flag==NULL?sp->count:sp->length;
+  int i,loc;
+  allocTable(sp,length);
+  for (i=0; i<old; i++) {
+    if (flag!=NULL && flag[i]!=1) continue;
+    loc=hash[i]%length;
+    while (sp->flag[loc]==1) loc=(loc+1)%length; // strings are unique, so take the first unused index
+    sp->data[loc]=data[i];
+    sp->hash[loc]=hash[i];
+    sp->flag[loc]=1;
+  } // move each string to its home, dropping deleted indexes
+  free(data);
+  free(hash);
+  free(flag);
+} // rebuild as a table of size length, promoting an array
+
+static void demote(SET *sp) {
+  char **data=malloc(sizeof(char*)*(sp->threshold+1));
+  assert(data!=NULL);
+  unsigned *hash=malloc(sizeof(unsigned)*(sp->threshold+1));
+  assert(hash!=NULL);
+  int i,num=0;
+  for (i=0; i<sp->length; i++) {
+    if (sp->flag[i]!=1) continue;
+    data[num]=sp->data[i];
+    hash[num]=sp->hash[i];
+    num++;
+  } // copy each filled index into the array
+  free(sp->data);
+  free(sp->hash);
+  free(sp->flag);
+  sp->data=data;
+  sp->hash=hash;
+  sp->flag=NULL;
+  sp->length=sp->threshold+1;
+  sp->deleted=0;
+} // turn a table back into an array
+
+SET *createAdaptiveSet(int maxElts, int threshold, bool demote) {
+  assert(threshold>0);
+  SET *sp=malloc(sizeof(SET));
+  assert(sp!=NULL);
+  sp->data=malloc(sizeof(char*)*(threshold+1));
+  assert(sp->data!=NULL);
+  sp->hash=malloc(sizeof(unsigned)*(threshold+1));
+  assert(sp->hash!=NULL); // room for one past threshold before promoting
+  sp->flag=NULL;
+  sp->length=threshold+1;
+  sp->count=0;
+  sp->deleted=0;
+  sp->hint=maxElts;
+  sp->threshold=threshold;
+  sp->demote=demote;
+  sp->strings=createArena();
+  return sp;
+} // create SET that promotes itself past threshold strings, and demotes itself again if demote is true
+
+SET *createSet(int maxElts) {
+  return createAdaptiveSet(maxElts,THRESHOLD,false);
+} // create SET expecting about maxElts strings
+
+void destroySet(SET *sp) {
+  assert(sp!=NULL);
+  destroyArena(sp->strings); // free all strings in data
+  free(sp->data);
+  free(sp->hash);
+  free(sp->flag);
+  free(sp);
+} // free sp and all data
+
+int numElements(SET *sp) {
+  assert(sp!=NULL);
+  return sp->count;
+} // get number of elements in sp
+
+void addElement(SET *sp, char *elt) {
+  assert(sp!=NULL);
+  unsigned hash=strhash(elt);
+  bool found;
+  int loc=search(sp,elt,hash,&found);
+  if (found) return; // return if elt already exists
+  if (sp->flag!=NULL && (sp->count+sp->deleted+1)*4>sp->length*3) {
+    rehash(sp,sp->count*2<sp->length?sp->length:sp->length*2); // clear deleted indexes, doubling unless they were most of the load
+    loc=search(sp,elt,hash,&found);
+  } // keep the table at most three quarters full
+  sp->data[loc]=copyString(sp->strings,elt,strlen(elt)); // copy elt into data
+  sp->hash[loc]=hash;
+  if (sp->flag!=NULL) {
+    if (sp->flag[loc]==-1) sp->deleted--; // reusing a deleted index
+    sp->flag[loc]=1;
+  }
+  sp->count++;
+  if (sp->flag==NULL && sp->count>sp->threshold) {
+    int n=sp->hint>sp->count?sp->hint:sp->count;
+    rehash(sp,n*2);
+  } // promote to a table at most half full
+} // add elt to sp if not already in sp
+
+void removeElement(SET *sp, char *elt) {
+  assert(sp!=NULL);
+  bool found;
+  int loc=search(sp,elt,strhash(elt),&found);
+  if (!found) return; // return if elt not in sp
+  freeString(sp->strings,sp->data[loc]);
+  sp->count--;
+  if (sp->flag==NULL) {
+    sp->data[loc]=sp->data[sp->count];
+    sp->hash[loc]=sp->hash[sp->count];
+    return;
+  } // fill the gap with the last string
+  sp->flag[loc]=-1; // mark loc as removed
+  sp->deleted++;
+  if (sp->demote && sp->count<sp->threshold/2) demote(sp);
+} // remove elt from sp if it exists
+
+char *findElement(SET *sp, char *elt) {
+  assert(sp!=NULL);
+  bool found;
+  int loc=search(sp,elt,strhash(elt),&found);
+  return found?sp->data[loc]:NULL; // return NULL if elt not in sp, else string matching elt
+} // find elt in sp
+
+char **getElements(SET *sp) {
+  assert(sp!=NULL);
+  char **arr=malloc(sizeof(char*)*(sp->count>0?sp->count:1)); // create array of size count
+  assert(arr!=NULL);
+  if (sp->flag==NULL) {
+    memcpy(arr,sp->data,sizeof(char*)*sp->count);
+    return arr;
+  } // an array is already packed
+  int i;
+  int num=0;
+  for (i=0; i<sp->length; i++) if (sp->flag[i]==1) arr[num++]=sp->data[i]; // add each filled index
+  return arr;
+} // return array of elements in sp
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) {
+  assert(sp!=NULL && visit!=NULL);
+  int i;
+  if (sp->flag==NULL) {
+    for (i=0; i<sp->count; i++) visit(sp->data[i],arg);
+    return;
+  } // array
+  for (i=0; i<sp->length; i++) if (sp->flag[i]==1) visit(sp->data[i],arg);
+} // call visit on each element; visit must not change sp
@@ -15,6 +15,9 @@
  *              flag array to keep track of each index's status. For this flag
  *              array, -1 indicates a deleted item, 0 indicates an unused index,
  *              and 1 indicates a filled index.
+ *
+ *              visitElements calls a function on each element straight from
+ *              the table, without building an array like getElements.
  */
 
 
@@ -117,4 +120,10 @@ void **getElements(SET *sp) { // O(m)
     } // if element exists
   } // for each element in sp
   return arr;
-} // return array of existing elements in sp
\ No newline at end of file
+} // return array of existing elements in sp
+
+void visitElements(SET *sp, void (*visit)(void *elt, void *arg), void *arg) { // O(m)
+  assert(sp!=NULL && visit!=NULL);
+  int i;
+  for (i=0; i<sp->length; i++) if (sp->flag[i]==1) visit(sp->data[i],arg);
+} // call visit on each element; visit must not change sp
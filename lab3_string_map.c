@@ -0,0 +1,154 @@
+/*
+ * File:        map.c
+ *
+ * Description: This file contains the functions for the "map.h" header file
+ *
+ *              The program will create the abstract data type MAP, which
+ *              maps strings to counts using the same hash table as the
+ *              string SET: linear probing over a data array with a flag
+ *              array marking each index as unused (0) or filled (1). Keys
+ *              are given as a pointer and a length, so tokens can be counted
+ *              straight out of a file buffer without ending them first.
+ *
+ *              incrementElement finds a key or the unused index where it
+ *              belongs in one probe sequence. The full hash and length of
+ *              each key are kept beside it, so most probes never compare
+ *              strings, memcmp never reads past the end of a shorter key,
+ *              and the table can be doubled without hashing the keys again.
+ *              Keys are copied into an ARENA owned by the MAP instead of
+ *              being allocated one at a time.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+#include "map.h"
+
+typedef struct map {
+  char **data;
+  unsigned *hash;
+  size_t *size; // size[i] is the length of data[i]
+  unsigned long long *tally;
+  int *flag;
+  int length;
+  int count;
+  ARENA *keys; // storage for the keys in data
+} MAP; // declare MAP structure
+
+static unsigned strhash(char *str, size_t len) {
+  unsigned hash=0;
+  while (len-->0) hash=31*hash+*str++;
+  return hash;
+} // get hash of the first len characters of str
+
+static void allocTable(MAP *mp, int length) {
+  mp->data=malloc(sizeof(char*)*length);
+  assert(mp->data!=NULL);
+  mp->hash=malloc(sizeof(unsigned)*length);
+  assert(mp->hash!=NULL);
+  mp->size=malloc(sizeof(size_t)*length);
+  assert(mp->size!=NULL);
+  mp->tally=malloc(sizeof(unsigned long long)*length);
+  assert(mp->tally!=NULL);
+  mp->flag=calloc(length,sizeof(int));
+  assert(mp->flag!=NULL); // all indexes unused
+  mp->length=length;
+} // allocate empty arrays of size length
+
+static void grow(MAP *mp) {
+  char **data=mp->data;
+  unsigned *hash=mp->hash;
+  size_t *size=mp->size;
+  unsigned long long *tally=mp->tally;
+  int *flag=mp->flag;
+  int length=mp->length;
+  int i,loc;
+  allocTable(mp,length*2);
+  for (i=0; i<length; i++) {
+    if (flag[i]!=1) continue;
+    loc=hash[i]%mp->length;
+    while (mp->flag[loc]==1) loc=(loc+1)%mp->length; // keys are unique, so take the first unused index
+    mp->data[loc]=data[i];
+    mp->hash[loc]=hash[i];
+    mp->size[loc]=size[i];
+    mp->tally[loc]=tally[i];
+    mp->flag[loc]=1;
+  } // move each key to its new index
+  free(data);
+  free(hash);
+  free(size);
+  free(tally);
+  free(flag);
+} // double the table size
+
+static int search(MAP *mp, char *key, size_t len, unsigned hash) {
+  int loc=hash%mp->length; // home index
+  while (mp->flag[loc]==1) {
+    if (mp->hash[loc]==hash && mp->size[loc]==len && memcmp(mp->data[loc],key,len)==0) return loc;
+    loc=(loc+1)%mp->length;
+  } // until an unused index
+  return loc;
+} // index of key, or the unused index where it belongs
+
+MAP *createMap(int maxElts) {
+  MAP *mp=malloc(sizeof(MAP));
+  assert(mp!=NULL);
+  allocTable(mp,maxElts>8?maxElts*2:16); // keep the table at most half full
+  mp->count=0;
+  mp->keys=createArena();
+  return mp;
+} // create MAP expecting about maxElts keys
+
+void destroyMap(MAP *mp) {
+  assert(mp!=NULL);
+  destroyArena(mp->keys); // free key storage
+  free(mp->data);
+  free(mp->hash);
+  free(mp->size);
+  free(mp->tally);
+  free(mp->flag);
+  free(mp);
+} // free mp and all keys
+
+int numEntries(MAP *mp) {
+  assert(mp!=NULL);
+  return mp->count;
+} // get number of keys in mp
+
+unsigned long long incrementElement(MAP *mp, char *key, size_t len) {
+  assert(mp!=NULL && key!=NULL);
+  unsigned hash=strhash(key,len);
+  int loc=search(mp,key,len,hash);
+  if (mp->flag[loc]==1) return ++mp->tally[loc]; // already counted
+  mp->data[loc]=copyString(mp->keys,key,len);
+  mp->hash[loc]=hash;
+  mp->size[loc]=len;
+  mp->tally[loc]=1;
+  mp->flag[loc]=1;
+  mp->count++;
+  if (mp->count*2>mp->length) grow(mp); // keep probe sequences short
+  return 1;
+} // add one to the count for key, inserting it if needed, and return the new count
+
+unsigned long long findCount(MAP *mp, char *key, size_t len) {
+  assert(mp!=NULL && key!=NULL);
+  int loc=search(mp,key,len,strhash(key,len));
+  return mp->flag[loc]==1?mp->tally[loc]:0;
+} // count for key, 0 if it was never added
+
+ENTRY *getEntries(MAP *mp) {
+  assert(mp!=NULL);
+  ENTRY *arr=malloc(sizeof(ENTRY)*(mp->count>0?mp->count:1));
+  assert(arr!=NULL);
+  int i;
+  int num=0;
+  for (i=0; i<mp->length; i++) {
+    if (mp->flag[i]==1) {
+      arr[num].key=mp->data[i];
+      arr[num].count=mp->tally[i];
+      num++;
+    } // if index is filled
+  } // for each index
+  return arr;
+} // return array of every key and its count
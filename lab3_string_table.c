@@ -14,18 +14,47 @@
  *              flag array to keep track of each index's status. For this flag
  *              array, -1 indicates a deleted item, 0 indicates an unused index,
  *              and 1 indicates a filled index.
+ *
+ *              A single probe sequence both looks for an element and finds
+ *              where it would go: search returns the match if there is one,
+ *              or else the first deleted or unused index it passed.
+ *
+ *              By default the table has maxElts indexes and adds are ignored
+ *              once every one is filled. After setAutoGrow the table is
+ *              rehashed into twice as many indexes whenever filled and
+ *              deleted indexes pass three quarters of it, so probe sequences
+ *              stay short. (If deletions make up most of that, it is rehashed
+ *              at the same size to clear them out.) If shrink is true it is
+ *              halved, never below maxElts, once fewer than an eighth of the
+ *              indexes are filled. reserveSet makes room for n strings up
+ *              front.
+ *
+ *              Strings are copied into an ARENA owned by the SET rather than
+ *              strdup'ed one at a time. A removed string's bytes go back to
+ *              the ARENA for the next string of about the same length.
+ *
+ *              visitElements calls a function on each string straight from
+ *              the table, without building an array like getElements.
  */
 
 
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
+#include "arena.h"
+#include "set.h"
 
 typedef struct set {
   char ** data;
   int * flag;
   int length;
   int count;
+  int deleted; // indexes flagged -1
+  int minLength; // never shrink below this
+  bool grow; // rehash when full instead of ignoring adds
+  bool shrink; // halve when an eighth full
+  ARENA *strings; // storage for the strings in data
 } SET; // declare SET structure
 
 static unsigned strhash(char *str) {
@@ -34,16 +63,46 @@ static unsigned strhash(char *str) {
   return hash;
 } // get home index of str
 
-static int search(SET *sp, char *elt) {
+static int search(SET *sp, char *elt, bool *found) {
   assert(sp!=NULL);
-  int i=0;
-  int loc=strhash(elt)%sp->length; // loc = home index
-  while (sp->flag[loc+i]!=0 && i<sp->length) {
-    if (sp->flag[(loc+i)%sp->length]==1) if (strcmp(sp->data[(loc+i)%sp->length],elt)==0) return (loc+i)%sp->length; // return if elt is found
-    i++;
-  } // while flag[loc+i] is not empty
-  return -1; // -1 if not found
-} // search for elt in set
+  int home=strhash(elt)%sp->length; // home index
+  int avail=-1; // first deleted index passed
+  int i,loc;
+  *found=false;
+  for (i=0; i<sp->length; i++) {
+    loc=(home+i)%sp->length;
+    if (sp->flag[loc]==0) return avail==-1?loc:avail; // elt would have been here
+    if (sp->flag[loc]==-1) {
+      if (avail==-1) avail=loc;
+    } else if (strcmp(sp->data[loc],elt)==0) {
+      *found=true;
+      return loc;
+    } // return if elt is found
+  } // probe until an unused index
+  return avail; // no unused index: -1 if there is no room at all
+} // index of elt if found, else where elt should be inserted
+
+static void rehash(SET *sp, int length) {
+  char **data=sp->data;
+  int *flag=sp->flag;
+  int old=sp->length;
+  int i,loc;
+  sp->data=malloc(sizeof(char*)*length);
+  assert(sp->data!=NULL);
+  sp->flag=calloc(length,sizeof(int));
+  assert(sp->flag!=NULL); // all indexes unused
+  sp->length=length;
+  sp->deleted=0;
+  for (i=0; i<old; i++) {
+    if (flag[i]!=1) continue;
+    loc=strhash(data[i])%length;
+    while (sp->flag[loc]==1) loc=(loc+1)%length; // elements are unique, so take the first unused index
+    sp->data[loc]=data[i];
+    sp->flag[loc]=1;
+  } // move each element to its new home, dropping deleted indexes
+  free(data);
+  free(flag);
+} // rebuild the table with length indexes; must be more than count
 
 SET *createSet(int maxElts) {
   SET *sp;
@@ -60,13 +119,28 @@ SET *createSet(int maxElts) {
 
   sp->length=maxElts;
   sp->count=0;
+  sp->deleted=0;
+  sp->minLength=maxElts>8?maxElts:8;
+  sp->grow=false;
+  sp->shrink=false;
+  sp->strings=createArena();
   return sp; // return SET pointer
 } // create SET of size maxElts
 
+void setAutoGrow(SET *sp, bool shrink) {
+  assert(sp!=NULL);
+  sp->grow=true;
+  sp->shrink=shrink;
+} // let sp grow past maxElts, and shrink again if shrink is true
+
+void reserveSet(SET *sp, int n) {
+  assert(sp!=NULL);
+  if (n>sp->length) rehash(sp,n+n/3+1); // room for n at three quarters full
+} // make room for at least n elements
+
 void destroySet(SET *sp) {
   assert(sp!=NULL);
-  int i;
-  for (i=0; i<sp->length; i++) if (sp->flag[i]==1) free(sp->data[i]); // free all existing strings in data
+  destroyArena(sp->strings); // free all existing strings in data
   free(sp->data);
   free(sp->flag);
   free(sp); // free sp and arrays
@@ -79,32 +153,40 @@ int numElements(SET *sp) {
 
 void addElement(SET *sp, char *elt) {
   assert(sp!=NULL);
-  if (sp->count == sp->length) return;
-  int loc=strhash(elt)%sp->length; // get home index
-  int i=0;
-  if (search(sp,elt)!=-1) return;
-  while (sp->flag[(loc+i)%sp->length]==1) {
-    if (strcmp(sp->data[loc+i],elt)==0) return; // return if elt already exists
-    i++;
-  } // while data[loc+i] is filled
-  sp->data[loc+i]=strdup(elt); // copy elt into data
-  sp->flag[loc+i]=1; // mark data[loc+i] as filled
+  if (sp->count == sp->length && !sp->grow) return;
+  bool found;
+  int loc;
+  if (sp->grow && (sp->count+sp->deleted+1)*4>sp->length*3) {
+    found=false;
+    if (sp->length>0) search(sp,elt,&found);
+    if (found) return; // return if elt already exists
+    rehash(sp,sp->count*2<sp->length?sp->length:sp->length>0?sp->length*2:8); // clear deleted indexes, doubling unless they were most of the load
+  } // keep the table at most three quarters full
+  loc=search(sp,elt,&found); // one probe finds elt or its slot
+  if (found) return; // return if elt already exists
+  if (sp->flag[loc]==-1) sp->deleted--; // reusing a deleted index
+  sp->data[loc]=copyString(sp->strings,elt,strlen(elt)); // copy elt into data
+  sp->flag[loc]=1; // mark data[loc] as filled
   sp->count++;
 } // add elt to sp if not already in sp
 
 void removeElement(SET *sp, char *elt) {
   assert(sp!=NULL);
-  int loc=search(sp,elt); // find elt in sp
-  if (loc==-1) return; // return if elt not in sp
-  free(sp->data[loc]);
+  bool found;
+  int loc=search(sp,elt,&found); // find elt in sp
+  if (!found) return; // return if elt not in sp
+  freeString(sp->strings,sp->data[loc]);
   sp->flag[loc]=-1; // mark loc as removed
   sp->count--;
+  sp->deleted++;
+  if (sp->shrink && sp->count*8<sp->length && sp->length/2>=sp->minLength) rehash(sp,sp->length/2); // halve when an eighth full
 } // remove elt from sp if it exists
 
 char *findElement(SET *sp, char *elt) {
   assert(sp!=NULL);
-  int loc=search(sp,elt); // get index of elt
-  return (loc==-1)?NULL:sp->data[loc]; // return NULL if elt not in sp, else string matching elt
+  bool found;
+  int loc=search(sp,elt,&found); // get index of elt
+  return found?sp->data[loc]:NULL; // return NULL if elt not in sp, else string matching elt
 } // find elt in sp
 
 char **getElements(SET *sp) {
@@ -120,4 +202,10 @@ char **getElements(SET *sp) {
     } // if data[i] has a value
   } // for each element in data
   return arr;
-} // return array of elements in data
\ No newline at end of file
+} // return array of elements in data
+
+void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg) {
+  assert(sp!=NULL && visit!=NULL);
+  int i;
+  for (i=0; i<sp->length; i++) if (sp->flag[i]==1) visit(sp->data[i],arg);
+} // call visit on each element; visit must not change sp
@@ -0,0 +1,32 @@
+/*
+ * File:        map.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for the map abstract data type.
+ */
+
+# ifndef MAP_H
+# define MAP_H
+
+# include <stddef.h>
+
+typedef struct map MAP;
+
+typedef struct entry {
+    char *key;
+    unsigned long long count;
+} ENTRY;
+
+extern MAP *createMap(int maxElts);
+
+extern void destroyMap(MAP *mp);
+
+extern int numEntries(MAP *mp);
+
+extern unsigned long long incrementElement(MAP *mp, char *key, size_t len);
+
+extern unsigned long long findCount(MAP *mp, char *key, size_t len);
+
+extern ENTRY *getEntries(MAP *mp);
+
+# endif /* MAP_H */
@@ -0,0 +1,90 @@
+/*
+ * File:        set.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for the set abstract data type of strings.
+ *
+ *              Every string SET (unsorted.c, sorted.c, gapped.c, btree.c,
+ *              table.c, and adaptive.c) defines the first group of
+ *              functions. The groups after it are only defined by the SETs
+ *              named above them.
+ */
+
+# ifndef SET_H
+# define SET_H
+
+# include <stdbool.h>
+
+typedef struct set SET;
+
+# define UNORGANIZED 0 /* policies for createOrganizedSet */
+# define MOVE_TO_FRONT 1
+# define TRANSPOSE 2
+
+extern SET *createSet(int maxElts);
+
+extern void destroySet(SET *sp);
+
+extern int numElements(SET *sp);
+
+extern void addElement(SET *sp, char *elt);
+
+extern void removeElement(SET *sp, char *elt);
+
+extern char *findElement(SET *sp, char *elt);
+
+extern char **getElements(SET *sp);
+
+extern void visitElements(SET *sp, void (*visit)(char *elt, void *arg), void *arg);
+
+/* unsorted.c, sorted.c, and table.c */
+
+extern void setAutoGrow(SET *sp, bool shrink);
+
+extern void reserveSet(SET *sp, int n);
+
+/* unsorted.c and sorted.c */
+
+extern char * const *viewElements(SET *sp);
+
+/* unsorted.c */
+
+extern SET *createOrganizedSet(int maxElts, int policy);
+
+extern double averageScanDepth(SET *sp);
+
+extern void setLazyDedup(SET *sp, double ratio);
+
+extern void addElements(SET *sp, char **elts, int n);
+
+extern void removeElements(SET *sp, char **elts, int n);
+
+/* sorted.c */
+
+extern SET *createSetFrom(char **items, int n);
+
+extern void setBuffered(SET *sp, int limit);
+
+extern void buildIndex(SET *sp);
+
+extern int lowerBound(SET *sp, char *elt);
+
+extern int upperBound(SET *sp, char *elt);
+
+extern int rangeCount(SET *sp, char *lo, char *hi);
+
+extern int prefixScan(SET *sp, char *prefix, void (*visit)(char *elt, void *arg), void *arg);
+
+extern SET *setUnion(SET *a, SET *b);
+
+extern SET *setIntersect(SET *a, SET *b);
+
+extern SET *setDifference(SET *a, SET *b);
+
+extern bool setIsSubset(SET *a, SET *b);
+
+/* adaptive.c */
+
+extern SET *createAdaptiveSet(int maxElts, int threshold, bool demote);
+
+# endif /* SET_H */
@@ -0,0 +1,56 @@
+/*
+ * File:        sketch.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for the sketch abstract data types.
+ */
+
+# ifndef SKETCH_H
+# define SKETCH_H
+
+# include <stddef.h>
+
+typedef struct hll HLL;
+
+typedef struct summary SUMMARY;
+
+typedef struct cms CMS;
+
+typedef struct counter {
+    char *key;
+    size_t len;
+    unsigned long long count;
+    unsigned long long error;
+} COUNTER;
+
+extern unsigned long long hashToken(char *str, size_t len);
+
+extern HLL *createHLL(int precision);
+
+extern void destroyHLL(HLL *hp);
+
+extern void addHLL(HLL *hp, unsigned long long hash);
+
+extern void mergeHLL(HLL *dst, HLL *src);
+
+extern double estimateHLL(HLL *hp);
+
+extern SUMMARY *createSummary(int k);
+
+extern void destroySummary(SUMMARY *sp);
+
+extern int numCounters(SUMMARY *sp);
+
+extern void addSummary(SUMMARY *sp, char *word, size_t len, unsigned long long hash);
+
+extern COUNTER *getCounters(SUMMARY *sp);
+
+extern CMS *createCMS(double epsilon, double delta);
+
+extern void destroyCMS(CMS *cp);
+
+extern void addCMS(CMS *cp, unsigned long long hash);
+
+extern unsigned long long estimateCMS(CMS *cp, unsigned long long hash);
+
+# endif /* SKETCH_H */
@@ -0,0 +1,34 @@
+/*
+ * File:        tokenizer.h
+ *
+ * Description: This file contains the public function and type
+ *              declarations for the tokenizer abstract data type.
+ *
+ *              nextWord ends each word in place by writing a zero byte after
+ *              it, so a buffer it walks must be writable and have one spare
+ *              byte after its last character. Buffers from mapFile do;
+ *              nextToken never writes to the buffer.
+ */
+
+# ifndef TOKENIZER_H
+# define TOKENIZER_H
+
+# include <stddef.h>
+
+typedef struct tokenizer TOKENIZER;
+
+extern char *mapFile(char *path, size_t *len);
+
+extern void unmapFile(char *buf, size_t len);
+
+extern TOKENIZER *createTokenizer(char *buf, size_t len, char *delims);
+
+extern void destroyTokenizer(TOKENIZER *tp);
+
+extern int isDelimiter(TOKENIZER *tp, int c);
+
+extern int nextToken(TOKENIZER *tp, char **word, size_t *len);
+
+extern char *nextWord(TOKENIZER *tp);
+
+# endif /* TOKENIZER_H */